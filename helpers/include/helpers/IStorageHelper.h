@@ -9,6 +9,8 @@
 #ifndef HELPERS_I_STORAGE_HELPER_H
 #define HELPERS_I_STORAGE_HELPER_H
 
+#include "helpers/interruptibleWait.h"
+
 #include <fuse.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -399,8 +401,6 @@ protected:
     }
 
 private:
-    static void throwOnInterrupted();
-
     template <typename Ret = void, typename... Arg1, typename... Arg2>
     Ret sync(void (IStorageHelper::*ash_fun)(Arg1...), Arg2 &&... args);
 
@@ -449,16 +449,7 @@ Ret IStorageHelper::sync(
 
 template <typename T> T IStorageHelper::waitFor(std::future<T> &f)
 {
-    using namespace std::literals;
-
-    for (auto t = 0ms; t < ASYNC_OPS_TIMEOUT; ++t) {
-        throwOnInterrupted();
-
-        if (f.wait_for(1ms) == std::future_status::ready)
-            return f.get();
-    }
-
-    throw std::system_error{std::make_error_code(std::errc::timed_out)};
+    return waitInterruptibly(f, ASYNC_OPS_TIMEOUT);
 }
 
 } // namespace helpers
@@ -0,0 +1,170 @@
+/**
+ * @file interruptibleWait.h
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#ifndef HELPERS_INTERRUPTIBLE_WAIT_H
+#define HELPERS_INTERRUPTIBLE_WAIT_H
+
+#include <fuse/fuse_lowlevel.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <system_error>
+#include <type_traits>
+
+namespace one {
+namespace helpers {
+
+/**
+ * How often a waiting thread checks whether its FUSE request has been
+ * interrupted, if it cannot be notified about the interruption.
+ */
+constexpr std::chrono::milliseconds INTERRUPT_CHECK_INTERVAL{50};
+
+/**
+ * @c InterruptibleWait tracks the deadline of a single blocking wait and the
+ * interruption of the FUSE request handled by the waiting thread.
+ * For low-level FUSE requests the wait registers itself for interruption
+ * notification and calls @c wake once the request is interrupted, so that
+ * the waiter does not have to poll.
+ * Waits of a single thread may be nested. A nested wait takes over the
+ * notification and hands it back to the enclosing wait once destroyed.
+ * @c InterruptibleWait must be constructed and destroyed while the waiter
+ * does not hold any lock taken by its own @c wake or the @c wake of an
+ * enclosing wait.
+ */
+class InterruptibleWait {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Constructor.
+     * @param timeout Time after which the wait expires.
+     * @param wake Function waking the waiter up on interruption.
+     */
+    template <typename Rep, typename Period>
+    InterruptibleWait(const std::chrono::duration<Rep, Period> timeout,
+        std::function<void()> wake = {})
+        : InterruptibleWait{
+              Clock::now() +
+                  std::chrono::duration_cast<Clock::duration>(timeout),
+              std::move(wake)}
+    {
+    }
+
+    /**
+     * Constructor.
+     * @param deadline Point in time at which the wait expires.
+     * @param wake Function waking the waiter up on interruption.
+     */
+    InterruptibleWait(
+        const Clock::time_point deadline, std::function<void()> wake = {});
+
+    /**
+     * Destructor.
+     * Unregisters the wait from interruption notification, registering the
+     * enclosing wait of the thread again.
+     */
+    ~InterruptibleWait();
+
+    InterruptibleWait(const InterruptibleWait &) = delete;
+    InterruptibleWait &operator=(const InterruptibleWait &) = delete;
+
+    /**
+     * @throws std::system_error with @c std::errc::operation_canceled if the
+     * FUSE request handled by the waiting thread has been interrupted.
+     */
+    void throwOnInterrupted() const;
+
+    /**
+     * @return true if the deadline of the wait has passed.
+     */
+    bool expired() const;
+
+    /**
+     * @return Point in time until which the waiter may block before checking
+     * for expiration and interruption again.
+     */
+    Clock::time_point wakeUpTime() const;
+
+private:
+    static void interrupt(fuse_req_t req, void *data);
+
+    const Clock::time_point m_deadline;
+    const std::function<void()> m_wake;
+    fuse_req_t m_request = nullptr;
+    InterruptibleWait *const m_enclosing;
+    std::atomic<bool> m_interrupted{false};
+};
+
+/**
+ * Waits for a future value, interrupting the wait when the FUSE request
+ * handled by the calling thread is interrupted.
+ * @param future The future to wait for, either @c std::future or
+ * @c std::shared_future.
+ * @param timeout The timeout to wait for.
+ * @returns The value of @c future.get().
+ * @throws std::system_error with @c std::errc::timed_out if the timeout has
+ * been exceeded or @c std::errc::operation_canceled if the FUSE request has
+ * been interrupted.
+ */
+template <typename Future, typename Rep, typename Period>
+auto waitInterruptibly(Future &future,
+    const std::chrono::duration<Rep, Period> timeout)
+    -> std::decay_t<decltype(future.get())>
+{
+    InterruptibleWait wait{timeout};
+
+    while (true) {
+        wait.throwOnInterrupted();
+
+        const auto status = future.wait_until(wait.wakeUpTime());
+        if (status == std::future_status::ready)
+            return future.get();
+
+        if (wait.expired())
+            throw std::system_error{
+                std::make_error_code(std::errc::timed_out)};
+    }
+}
+
+/**
+ * Waits on a condition variable until @p pred is satisfied, interrupting the
+ * wait when the FUSE request handled by the calling thread is interrupted.
+ * @param condition The condition variable to wait on.
+ * @param lock Lock on the mutex associated with @p condition.
+ * @param wait The wait whose deadline should be respected.
+ * @param pred The predicate to satisfy.
+ * @return false if the wait expired before @p pred has been satisfied.
+ * @throws std::system_error with @c std::errc::operation_canceled if the
+ * FUSE request has been interrupted.
+ */
+template <typename Predicate>
+bool waitInterruptibly(std::condition_variable &condition,
+    std::unique_lock<std::mutex> &lock, const InterruptibleWait &wait,
+    Predicate &&pred)
+{
+    while (!pred()) {
+        wait.throwOnInterrupted();
+
+        if (wait.expired())
+            return false;
+
+        condition.wait_until(lock, wait.wakeUpTime());
+    }
+
+    return true;
+}
+
+} // namespace helpers
+} // namespace one
+
+#endif // HELPERS_INTERRUPTIBLE_WAIT_H
@@ -7,7 +7,6 @@
  */
 
 #include "helpers/IStorageHelper.h"
-#include "fuseOperations.h"
 
 #include <sys/stat.h>
 
@@ -32,12 +31,5 @@ const std::unordered_map<int, Flag> IStorageHelper::s_maskTranslation{
     {S_IFCHR, Flag::IFCHR}, {S_IFBLK, Flag::IFBLK}, {S_IFIFO, Flag::IFIFO},
     {S_IFSOCK, Flag::IFSOCK}};
 
-void IStorageHelper::throwOnInterrupted()
-{
-    if (fuseInterrupted())
-        throw std::system_error{
-            std::make_error_code(std::errc::operation_canceled)};
-}
-
 } // namespace helpers
 } // namespace one
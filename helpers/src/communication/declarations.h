@@ -13,6 +13,7 @@
 // ClientMessage and ServerMessage are not forward-declared, because it's to be
 // used from header-only communication classes.
 #include "messages.pb.h"
+#include "messages/serverMessage.h"
 
 #include <chrono>
 #include <memory>
@@ -24,7 +25,7 @@ constexpr int DEFAULT_RETRY_NUMBER = 2;
 constexpr int STREAM_MSG_ACK_WINDOW = 100;
 constexpr std::chrono::seconds STREAM_MSG_REQ_WINDOW{30};
 
-using ServerMessagePtr = std::unique_ptr<clproto::ServerMessage>;
+using ServerMessagePtr = messages::ProtocolServerMessagePtr;
 using ClientMessagePtr = std::unique_ptr<clproto::ClientMessage>;
 
 } // namespace communication
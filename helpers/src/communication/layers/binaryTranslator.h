@@ -50,7 +50,7 @@ public:
     /**
      * Wraps lower layer's @c setOnMessageCallback.
      * The incoming message is deserialized into a @c clproto::ServerMessage
-     * instance.
+     * instance taken from the pool of released messages.
      * @see ConnectionPool::setOnMessageCallback()
      */
     auto setOnMessageCallback(
@@ -80,8 +80,7 @@ auto BinaryTranslator<LowerLayer>::setHandshake(
 
         [onHandshakeResponse = std::move(onHandshakeResponse)](
             std::string message) {
-            /// @todo A potential place for optimization [static serverMsg]
-            auto serverMsg = std::make_unique<clproto::ServerMessage>();
+            auto serverMsg = messages::acquireProtocolServerMessage();
 
             if (!serverMsg->ParseFromString(message))
                 return std::make_error_code(std::errc::protocol_error);
@@ -99,7 +98,7 @@ auto BinaryTranslator<LowerLayer>::setOnMessageCallback(
     return LowerLayer::setOnMessageCallback([onMessageCallback =
                                                  std::move(onMessageCallback)](
         std::string message) {
-        auto serverMsg = std::make_unique<clproto::ServerMessage>();
+        auto serverMsg = messages::acquireProtocolServerMessage();
         if (serverMsg->ParseFromString(message)) {
             onMessageCallback(std::move(serverMsg));
         }
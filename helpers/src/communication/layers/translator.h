@@ -10,7 +10,7 @@
 #define HELPERS_COMMUNICATION_LAYERS_TRANSLATOR_H
 
 #include "communication/declarations.h"
-#include "fuseOperations.h"
+#include "helpers/interruptibleWait.h"
 #include "messages/clientMessage.h"
 #include "messages/handshakeRequest.h"
 #include "messages/handshakeResponse.h"
@@ -252,26 +252,37 @@ SvrMsg wait(
     using namespace std::literals;
     assert(timeout > 0ms);
 
-    for (auto t = 0ms; t < timeout; ++t) {
-        if (helpers::fuseInterrupted())
-            throw std::system_error{
-                std::make_error_code(std::errc::operation_canceled)};
+    return helpers::waitInterruptibly(msg, timeout);
+}
 
-        const auto status = msg.wait_for(1ms);
-        assert(status != std::future_status::deferred);
+/**
+ * A convenience overload for @c wait.
+ * Calls @c wait with @c DEFAULT_TIMEOUT.
+ */
+template <class SvrMsg> SvrMsg wait(std::future<SvrMsg> &msg)
+{
+    return wait(msg, DEFAULT_TIMEOUT);
+}
 
-        if (status == std::future_status::ready)
-            return msg.get();
-    }
+/**
+ * An overload of @c wait for futures shared by many waiters.
+ * @see wait(std::future<SvrMsg> &, const std::chrono::duration<Rep, Period>)
+ */
+template <class SvrMsg, typename Rep, typename Period>
+SvrMsg wait(std::shared_future<SvrMsg> &msg,
+    const std::chrono::duration<Rep, Period> timeout)
+{
+    using namespace std::literals;
+    assert(timeout > 0ms);
 
-    throw std::system_error{std::make_error_code(std::errc::timed_out)};
+    return helpers::waitInterruptibly(msg, timeout);
 }
 
 /**
  * A convenience overload for @c wait.
  * Calls @c wait with @c DEFAULT_TIMEOUT.
  */
-template <class SvrMsg> SvrMsg wait(std::future<SvrMsg> &msg)
+template <class SvrMsg> SvrMsg wait(std::shared_future<SvrMsg> &msg)
 {
     return wait(msg, DEFAULT_TIMEOUT);
 }
@@ -86,6 +86,12 @@ public:
      */
     void reset();
 
+    /**
+     * @return Total serialized size of messages kept in the stream until they
+     * are acknowledged by the remote party.
+     */
+    virtual std::size_t bufferedSize() const { return m_bufferedSize; }
+
     TypedStream(TypedStream &&) = delete;
     TypedStream(const TypedStream &) = delete;
     TypedStream &operator=(TypedStream &&) = delete;
@@ -98,6 +104,7 @@ private:
     const std::uint64_t m_streamId;
     std::function<void()> m_unregister;
     std::atomic<std::uint64_t> m_sequenceId{0};
+    std::atomic<std::size_t> m_bufferedSize{0};
     std::shared_timed_mutex m_bufferMutex;
     tbb::concurrent_priority_queue<ClientMessagePtr, StreamLess> m_buffer;
 };
@@ -139,6 +146,7 @@ template <class Communicator> void TypedStream<Communicator>::reset()
     m_sequenceId = 0;
     std::vector<ClientMessagePtr> processed;
     for (ClientMessagePtr it; m_buffer.try_pop(it);) {
+        m_bufferedSize -= it->GetCachedSize();
         it->mutable_message_stream()->set_sequence_number(m_sequenceId++);
         processed.emplace_back(std::move(it));
     }
@@ -150,6 +158,7 @@ template <class Communicator>
 void TypedStream<Communicator>::saveAndPass(ClientMessagePtr msg)
 {
     auto msgCopy = std::make_unique<clproto::ClientMessage>(*msg);
+    m_bufferedSize += msgCopy->ByteSize();
 
     {
         std::shared_lock<std::shared_timed_mutex> lock{m_bufferMutex};
@@ -182,6 +191,7 @@ void TypedStream<Communicator>::handleMessageRequest(
     for (auto &msgStream : processed) {
         if (msgStream->message_stream().sequence_number() >=
             msg.lower_sequence_number()) {
+            m_bufferedSize -= msgStream->GetCachedSize();
             saveAndPass(std::move(msgStream));
         }
         else {
@@ -200,6 +210,8 @@ void TypedStream<Communicator>::handleMessageAcknowledgement(
             m_buffer.emplace(std::move(it));
             break;
         }
+
+        m_bufferedSize -= it->GetCachedSize();
     }
 }
 
@@ -10,6 +10,7 @@
 
 namespace {
 thread_local bool fuseSessionActive = false;
+thread_local fuse_req_t fuseSessionRequest = nullptr;
 } // namespace
 
 namespace one {
@@ -17,7 +18,23 @@ namespace helpers {
 
 void activateFuseSession() { fuseSessionActive = true; }
 
-bool fuseInterrupted() { return fuseSessionActive && fuse_interrupted(); }
+void activateFuseSession(fuse_req_t req) { fuseSessionRequest = req; }
+
+void deactivateFuseSession()
+{
+    fuseSessionActive = false;
+    fuseSessionRequest = nullptr;
+}
+
+fuse_req_t fuseRequest() { return fuseSessionRequest; }
+
+bool fuseInterrupted()
+{
+    if (fuseSessionRequest)
+        return fuse_req_interrupted(fuseSessionRequest);
+
+    return fuseSessionActive && fuse_interrupted();
+}
 
 } // namespace helpers
-} // namespace one
\ No newline at end of file
+} // namespace one
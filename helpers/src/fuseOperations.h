@@ -7,6 +7,7 @@
  */
 
 #include <fuse.h>
+#include <fuse/fuse_lowlevel.h>
 
 namespace one {
 namespace helpers {
@@ -17,11 +18,28 @@ namespace helpers {
 void activateFuseSession();
 
 /**
- * Wraps the fuse_interrupted function.
+ * Defines a low-level FUSE request as handled by calling thread.
+ * @param req The request.
+ */
+void activateFuseSession(fuse_req_t req);
+
+/**
+ * Defines FUSE session as inactive for calling thread, e.g. once a low-level
+ * FUSE request has been handled.
+ */
+void deactivateFuseSession();
+
+/**
+ * @return Low-level FUSE request handled by calling thread, if any.
+ */
+fuse_req_t fuseRequest();
+
+/**
+ * Wraps the fuse_interrupted and fuse_req_interrupted functions.
  * @return true if @c fuseEnabled is set to true and FUSE operation has been
  * aborted by user, otherwise false.
  */
 bool fuseInterrupted();
 
 } // namespace helpers
-} // namespace one
\ No newline at end of file
+} // namespace one
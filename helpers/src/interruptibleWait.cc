@@ -0,0 +1,80 @@
+/**
+ * @file interruptibleWait.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "helpers/interruptibleWait.h"
+#include "fuseOperations.h"
+
+#include <algorithm>
+
+namespace {
+/// Innermost wait of the calling thread, registered for interruption
+/// notification of its FUSE request.
+thread_local one::helpers::InterruptibleWait *currentWait = nullptr;
+} // namespace
+
+namespace one {
+namespace helpers {
+
+InterruptibleWait::InterruptibleWait(
+    const Clock::time_point deadline, std::function<void()> wake)
+    : m_deadline{deadline}
+    , m_wake{std::move(wake)}
+    , m_request{fuseRequest()}
+    , m_enclosing{currentWait}
+{
+    // The callback is called immediately if the request has already been
+    // interrupted
+    if (m_request) {
+        currentWait = this;
+        fuse_req_interrupt_func(m_request, &InterruptibleWait::interrupt, this);
+    }
+}
+
+InterruptibleWait::~InterruptibleWait()
+{
+    if (!m_request)
+        return;
+
+    // Once replaced, the callback is guaranteed not to be running; an
+    // enclosing wait is registered again, and is notified at once if the
+    // request has been interrupted in the meantime
+    currentWait = m_enclosing;
+    if (m_enclosing && m_enclosing->m_request == m_request)
+        fuse_req_interrupt_func(
+            m_request, &InterruptibleWait::interrupt, m_enclosing);
+    else
+        fuse_req_interrupt_func(m_request, nullptr, nullptr);
+}
+
+void InterruptibleWait::throwOnInterrupted() const
+{
+    if (m_request ? m_interrupted.load() : fuseInterrupted())
+        throw std::system_error{
+            std::make_error_code(std::errc::operation_canceled)};
+}
+
+bool InterruptibleWait::expired() const { return Clock::now() >= m_deadline; }
+
+InterruptibleWait::Clock::time_point InterruptibleWait::wakeUpTime() const
+{
+    if (m_request && m_wake)
+        return m_deadline;
+
+    return std::min(m_deadline, Clock::now() + INTERRUPT_CHECK_INTERVAL);
+}
+
+void InterruptibleWait::interrupt(fuse_req_t /*req*/, void *data)
+{
+    auto self = static_cast<InterruptibleWait *>(data);
+    self->m_interrupted = true;
+    if (self->m_wake)
+        self->m_wake();
+}
+
+} // namespace helpers
+} // namespace one
@@ -15,7 +15,7 @@ namespace one {
 namespace messages {
 
 HandshakeResponse::HandshakeResponse(
-    std::unique_ptr<ProtocolServerMessage> serverMessage)
+    ProtocolServerMessagePtr serverMessage)
 {
     auto &msg = serverMessage->handshake_response();
     m_status = translateStatus(msg);
@@ -32,7 +32,7 @@ public:
      * @param serverMessage Protocol Buffers message representing @c
      * HandshakeResponse counterpart.
      */
-    HandshakeResponse(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    HandshakeResponse(ProtocolServerMessagePtr serverMessage);
 
     /**
      * @return true if a token error occurred during handshake, otherwise false
@@ -16,7 +16,7 @@ namespace one {
 namespace messages {
 
 MessageAcknowledgement::MessageAcknowledgement(
-    std::unique_ptr<ProtocolServerMessage> serverMessage)
+    ProtocolServerMessagePtr serverMessage)
 {
     auto &messageAcknowledgementMsg = serverMessage->message_acknowledgement();
     m_streamId = messageAcknowledgementMsg.stream_id();
@@ -30,7 +30,7 @@ public:
      * MessageAcknowledgement counterpart.
      */
     MessageAcknowledgement(
-        std::unique_ptr<ProtocolServerMessage> serverMessage);
+        ProtocolServerMessagePtr serverMessage);
 
     /**
      * @return ID of stream acknowledged message belongs to.
@@ -16,7 +16,7 @@ namespace one {
 namespace messages {
 
 MessageRequest::MessageRequest(
-    std::unique_ptr<ProtocolServerMessage> serverMessage)
+    ProtocolServerMessagePtr serverMessage)
 {
     auto &messageRequestMsg = serverMessage->message_request();
     m_streamId = messageRequestMsg.stream_id();
@@ -28,7 +28,7 @@ public:
      * @param serverMessage Protocol Buffers message representing @c
      * MessageRequest counterpart.
      */
-    MessageRequest(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    MessageRequest(ProtocolServerMessagePtr serverMessage);
 
     /**
      * @return ID of stream requested messages belong to.
@@ -13,7 +13,7 @@
 namespace one {
 namespace messages {
 
-MessageStreamReset::MessageStreamReset(std::unique_ptr<ProtocolServerMessage>)
+MessageStreamReset::MessageStreamReset(ProtocolServerMessagePtr)
 {
 }
 
@@ -28,7 +28,7 @@ public:
      * @param serverMessage Protocol Buffers message representing @c
      * MessageStreamReset counterpart.
      */
-    MessageStreamReset(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    MessageStreamReset(ProtocolServerMessagePtr serverMessage);
 
     virtual std::string toString() const override;
 };
@@ -13,7 +13,7 @@
 namespace one {
 namespace messages {
 
-Pong::Pong(std::unique_ptr<ProtocolServerMessage> serverMessage)
+Pong::Pong(ProtocolServerMessagePtr serverMessage)
 {
     if (serverMessage->pong().has_data())
         m_data = serverMessage->pong().data();
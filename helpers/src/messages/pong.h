@@ -30,7 +30,7 @@ public:
      * @param serverMessage Protocol Buffers message representing @c
      * Pong counterpart.
      */
-    Pong(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    Pong(ProtocolServerMessagePtr serverMessage);
 
     const boost::optional<std::string> &data() const;
 
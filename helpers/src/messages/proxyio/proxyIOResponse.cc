@@ -18,7 +18,7 @@ namespace messages {
 namespace proxyio {
 
 ProxyIOResponse::ProxyIOResponse(
-    const std::unique_ptr<ProtocolServerMessage> &serverMessage)
+    const ProtocolServerMessagePtr &serverMessage)
 {
     if (!serverMessage->has_proxyio_response())
         throw std::system_error{std::make_error_code(std::errc::protocol_error),
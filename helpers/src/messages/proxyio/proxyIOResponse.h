@@ -30,7 +30,7 @@ public:
      * received message's status is not OK.
      */
     ProxyIOResponse(
-        const std::unique_ptr<ProtocolServerMessage> &serverMessage);
+        const ProtocolServerMessagePtr &serverMessage);
 
     virtual ~ProxyIOResponse() = default;
 };
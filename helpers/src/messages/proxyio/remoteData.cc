@@ -16,7 +16,7 @@ namespace one {
 namespace messages {
 namespace proxyio {
 
-RemoteData::RemoteData(std::unique_ptr<ProtocolServerMessage> serverMessage)
+RemoteData::RemoteData(ProtocolServerMessagePtr serverMessage)
     : ProxyIOResponse(serverMessage)
 {
     if (!serverMessage->proxyio_response().has_remote_data())
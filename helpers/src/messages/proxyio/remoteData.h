@@ -30,7 +30,7 @@ public:
      * @param serverMessage Protocol Buffers message representing
      * @c RemoteData counterpart.
      */
-    RemoteData(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    RemoteData(ProtocolServerMessagePtr serverMessage);
 
     /**
      * @return The data.
@@ -17,7 +17,7 @@ namespace messages {
 namespace proxyio {
 
 RemoteWriteResult::RemoteWriteResult(
-    std::unique_ptr<ProtocolServerMessage> serverMessage)
+    ProtocolServerMessagePtr serverMessage)
     : ProxyIOResponse{serverMessage}
 {
     if (!serverMessage->proxyio_response().has_remote_write_result())
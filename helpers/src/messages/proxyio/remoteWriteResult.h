@@ -31,7 +31,7 @@ public:
      * @param serverMessage Protocol Buffers message representing
      * @c RemoteWriteResult counterpart.
      */
-    RemoteWriteResult(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    RemoteWriteResult(ProtocolServerMessagePtr serverMessage);
 
     /**
      * @return The number of bytes written.
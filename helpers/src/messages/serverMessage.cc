@@ -0,0 +1,67 @@
+/**
+ * @file serverMessage.cc
+ * @author Krzysztof Trzepla
+ * @copyright (C) 2015 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "messages/serverMessage.h"
+
+#include "messages.pb.h"
+
+#include <mutex>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t PROTOCOL_SERVER_MESSAGE_POOL_SIZE = 256;
+
+struct ProtocolServerMessagePool {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<one::messages::ProtocolServerMessage>>
+        messages;
+};
+
+ProtocolServerMessagePool &pool()
+{
+    // Never destroyed, so that messages released during static destruction
+    // still find the pool.
+    static auto *instance = new ProtocolServerMessagePool;
+    return *instance;
+}
+
+} // namespace
+
+namespace one {
+namespace messages {
+
+void ProtocolServerMessageDeleter::operator()(
+    ProtocolServerMessage *message) const
+{
+    std::unique_ptr<ProtocolServerMessage> owned{message};
+    owned->Clear();
+
+    auto &p = pool();
+    std::lock_guard<std::mutex> guard{p.mutex};
+    if (p.messages.size() < PROTOCOL_SERVER_MESSAGE_POOL_SIZE)
+        p.messages.emplace_back(std::move(owned));
+}
+
+ProtocolServerMessagePtr acquireProtocolServerMessage()
+{
+    auto &p = pool();
+    {
+        std::lock_guard<std::mutex> guard{p.mutex};
+        if (!p.messages.empty()) {
+            ProtocolServerMessagePtr message{p.messages.back().release()};
+            p.messages.pop_back();
+            return message;
+        }
+    }
+
+    return ProtocolServerMessagePtr{new ProtocolServerMessage};
+}
+
+} // namespace messages
+} // namespace one
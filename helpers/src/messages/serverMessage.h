@@ -9,6 +9,7 @@
 #ifndef ONECLIENT_MESSAGES_SERVER_MESSAGE_H
 #define ONECLIENT_MESSAGES_SERVER_MESSAGE_H
 
+#include <memory>
 #include <string>
 
 namespace one {
@@ -21,6 +22,26 @@ namespace messages {
 
 using ProtocolServerMessage = one::clproto::ServerMessage;
 
+/**
+ * Deleter of inbound protocol messages. A deleted message is cleared and
+ * returned to a bounded pool, from which @c acquireProtocolServerMessage()
+ * takes messages to parse further inbound frames into. Messages allocated
+ * with the default deleter are accepted as well.
+ */
+struct ProtocolServerMessageDeleter {
+    ProtocolServerMessageDeleter() = default;
+    ProtocolServerMessageDeleter(std::default_delete<ProtocolServerMessage>) {}
+    void operator()(ProtocolServerMessage *message) const;
+};
+
+using ProtocolServerMessagePtr =
+    std::unique_ptr<ProtocolServerMessage, ProtocolServerMessageDeleter>;
+
+/**
+ * @return An empty protocol message, reused from the pool if available.
+ */
+ProtocolServerMessagePtr acquireProtocolServerMessage();
+
 /**
  * The ServerMessage class represents a message that can by sent form the server
  * to the client.
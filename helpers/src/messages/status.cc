@@ -130,7 +130,7 @@ Status::Status(std::error_code ec, std::string desc)
 {
 }
 
-Status::Status(std::unique_ptr<ProtocolServerMessage> serverMessage)
+Status::Status(ProtocolServerMessagePtr serverMessage)
     : Status{*serverMessage->mutable_status()}
 {
 }
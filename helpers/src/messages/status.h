@@ -53,7 +53,7 @@ public:
      * @param serverMessage Protocol Buffers message representing @c
      * Status counterpart.
      */
-    Status(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    Status(ProtocolServerMessagePtr serverMessage);
 
     /**
      * Constructor.
@@ -92,7 +92,7 @@ private:
 
 class ExampleServerMessage : public messages::ServerMessage {
 public:
-    ExampleServerMessage(std::unique_ptr<ProtocolServerMessage> protocolMsg_)
+    ExampleServerMessage(ProtocolServerMessagePtr protocolMsg_)
         : m_protocolMsg{std::move(protocolMsg_)}
     {
     }
@@ -102,7 +102,7 @@ public:
     ProtocolServerMessage &protocolMsg() const { return *m_protocolMsg; }
 
 private:
-    std::unique_ptr<ProtocolServerMessage> m_protocolMsg;
+    ProtocolServerMessagePtr m_protocolMsg;
 };
 
 class CommunicatorProxy {
@@ -17,6 +17,7 @@
 #include <functional>
 #include <string>
 #include <system_error>
+#include <vector>
 
 using namespace one;
 using namespace one::communication;
@@ -130,3 +131,32 @@ TEST_F(BinaryTranslatorTest, setHandshakeShouldDeserializeBytes)
 
     ASSERT_TRUE(called);
 }
+
+TEST_F(BinaryTranslatorTest, setOnMessageCallbackShouldReuseReleasedMessages)
+{
+    std::function<void(std::string)> byteOnMessageCallback;
+    EXPECT_CALL(binaryTranslator.mock, setOnMessageCallback(_))
+        .WillOnce(SaveArg<0>(&byteOnMessageCallback));
+
+    std::vector<clproto::ServerMessage *> received;
+    std::vector<bool> hasStream;
+    binaryTranslator.setOnMessageCallback([&](ServerMessagePtr msg) {
+        received.emplace_back(msg.get());
+        hasStream.emplace_back(msg->has_message_stream());
+    });
+
+    clproto::ServerMessage protoMsg;
+    protoMsg.set_message_id(randomString());
+    protoMsg.mutable_message_stream()->set_stream_id(randomInt());
+    protoMsg.mutable_message_stream()->set_sequence_number(randomInt());
+    byteOnMessageCallback(protoMsg.SerializeAsString());
+
+    protoMsg.Clear();
+    protoMsg.set_message_id(randomString());
+    byteOnMessageCallback(protoMsg.SerializeAsString());
+
+    ASSERT_EQ(2u, received.size());
+    EXPECT_EQ(received[0], received[1]);
+    EXPECT_TRUE(hasStream[0]);
+    EXPECT_FALSE(hasStream[1]);
+}
@@ -0,0 +1,148 @@
+/**
+ * @file interruptibleWait_test.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "fuseOperations.h"
+#include "helpers/interruptibleWait.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+using namespace ::testing;
+using namespace one::helpers;
+using namespace std::literals;
+
+namespace {
+fuse_interrupt_func_t interruptFunc = nullptr;
+void *interruptData = nullptr;
+} // namespace
+
+// Replaces the libfuse function, so that registration of waits for
+// interruption notification can be checked without a FUSE session.
+void fuse_req_interrupt_func(
+    fuse_req_t /*req*/, fuse_interrupt_func_t func, void *data)
+{
+    interruptFunc = func;
+    interruptData = data;
+}
+
+TEST(InterruptibleWaitTest, waitShouldReturnReadyFutureValue)
+{
+    std::promise<int> promise;
+    auto future = promise.get_future();
+    promise.set_value(42);
+
+    EXPECT_EQ(42, waitInterruptibly(future, 1s));
+}
+
+TEST(InterruptibleWaitTest, waitShouldReturnFutureValueOnceSet)
+{
+    std::promise<int> promise;
+    auto future = promise.get_future();
+    std::thread setter{[&] {
+        std::this_thread::sleep_for(10ms);
+        promise.set_value(42);
+    }};
+
+    EXPECT_EQ(42, waitInterruptibly(future, 10s));
+    setter.join();
+}
+
+TEST(InterruptibleWaitTest, waitShouldThrowOnTimeout)
+{
+    std::promise<int> promise;
+    auto future = promise.get_future();
+
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        waitInterruptibly(future, 100ms);
+        FAIL() << "timed_out expected";
+    }
+    catch (const std::system_error &e) {
+        EXPECT_EQ(std::make_error_code(std::errc::timed_out), e.code());
+    }
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 100ms);
+}
+
+TEST(InterruptibleWaitTest, waitShouldRethrowFutureException)
+{
+    std::promise<int> promise;
+    auto future = promise.get_future();
+    promise.set_exception(std::make_exception_ptr(
+        std::system_error{std::make_error_code(std::errc::io_error)}));
+
+    EXPECT_THROW(waitInterruptibly(future, 1s), std::system_error);
+}
+
+TEST(InterruptibleWaitTest, waitShouldReturnOnceConditionIsNotified)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool ready = false;
+
+    std::thread notifier{[&] {
+        std::this_thread::sleep_for(10ms);
+        std::lock_guard<std::mutex> guard{mutex};
+        ready = true;
+        condition.notify_all();
+    }};
+
+    InterruptibleWait wait{10s};
+    std::unique_lock<std::mutex> lock{mutex};
+    EXPECT_TRUE(waitInterruptibly(condition, lock, wait, [&] { return ready; }));
+
+    lock.unlock();
+    notifier.join();
+}
+
+TEST(InterruptibleWaitTest, waitShouldReturnFalseOnConditionTimeout)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    InterruptibleWait wait{100ms};
+    std::unique_lock<std::mutex> lock{mutex};
+    EXPECT_FALSE(
+        waitInterruptibly(condition, lock, wait, [] { return false; }));
+    EXPECT_TRUE(wait.expired());
+}
+
+TEST(InterruptibleWaitTest, nestedWaitShouldRestoreEnclosingRegistration)
+{
+    int request = 0;
+    const auto req = reinterpret_cast<fuse_req_t>(&request);
+    activateFuseSession(req);
+
+    bool woken = false;
+    {
+        InterruptibleWait outer{10s, [&] { woken = true; }};
+        const auto outerData = interruptData;
+        ASSERT_NE(nullptr, outerData);
+
+        {
+            InterruptibleWait inner{10s};
+            EXPECT_NE(outerData, interruptData);
+        }
+
+        EXPECT_EQ(outerData, interruptData);
+        ASSERT_NE(nullptr, interruptFunc);
+        interruptFunc(req, interruptData);
+
+        EXPECT_TRUE(woken);
+        EXPECT_THROW(outer.throwOnInterrupted(), std::system_error);
+    }
+
+    EXPECT_EQ(nullptr, interruptData);
+    deactivateFuseSession();
+}
@@ -10,10 +10,13 @@
 #define ONECLIENT_FS_LOGIC_H
 
 #include "cache/cacheExpirationHelper.h"
+#include "cache/directoryCache.h"
 #include "cache/fileContextCache.h"
 #include "cache/forceProxyIOCache.h"
 #include "cache/helpersCache.h"
+#include "cache/inodeCache.h"
 #include "cache/metadataCache.h"
+#include "cache/writeAccumulator.h"
 #include "events/eventManager.h"
 #include "fsSubscriptions.h"
 #include "messages/fuse/checksum.h"
@@ -22,19 +25,26 @@
 #include "messages/fuse/helperParams.h"
 
 #include <asio/buffer.hpp>
+#include <asio/executor_work.hpp>
+#include <asio/io_service.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/optional.hpp>
 #include <fuse.h>
+#include <fuse/fuse_lowlevel.h>
 #include <tbb/concurrent_hash_map.h>
 #include <tbb/concurrent_unordered_set.h>
 
+#include <atomic>
 #include <cstdint>
+#include <ctime>
 #include <functional>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
-#include <tuple>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace one {
@@ -71,7 +81,7 @@ public:
 
     /**
     * Destructor.
-    * Cancels scheduling operations.
+    * Cancels scheduling operations and stops I/O worker threads.
     */
     ~FsLogic();
 
@@ -239,12 +249,200 @@ public:
     int create(boost::filesystem::path path, const mode_t mode,
         struct fuse_file_info *const fileInfo);
 
+    /**
+     * FUSE low-level @c lookup callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void lookup(const fuse_ino_t parent, const std::string &name,
+        struct fuse_entry_param *const entry);
+
+    /**
+     * FUSE low-level @c forget callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void forget(const fuse_ino_t ino, const std::uint64_t nlookup);
+
+    /**
+     * FUSE low-level @c getattr callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void getattr(const fuse_ino_t ino, struct stat *const statbuf);
+
+    /**
+     * FUSE low-level @c setattr callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void setattr(const fuse_ino_t ino, const struct stat &attr,
+        const int toSet, struct stat *const statbuf);
+
+    /**
+     * FUSE low-level @c mknod callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void mknod(const fuse_ino_t parent, const std::string &name,
+        const mode_t mode, const dev_t dev,
+        struct fuse_entry_param *const entry);
+
+    /**
+     * FUSE low-level @c mkdir callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void mkdir(const fuse_ino_t parent, const std::string &name,
+        const mode_t mode, struct fuse_entry_param *const entry);
+
+    /**
+     * FUSE low-level @c unlink callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void unlink(const fuse_ino_t parent, const std::string &name);
+
+    /**
+     * FUSE low-level @c rmdir callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void rmdir(const fuse_ino_t parent, const std::string &name);
+
+    /**
+     * FUSE low-level @c rename callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void rename(const fuse_ino_t parent, const std::string &name,
+        const fuse_ino_t newParent, const std::string &newName);
+
+    /**
+     * FUSE low-level @c open callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void open(const fuse_ino_t ino, struct fuse_file_info *const fileInfo);
+
+    /**
+     * FUSE low-level @c read callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    std::size_t read(const fuse_ino_t ino, asio::mutable_buffer buf,
+        const off_t offset, struct fuse_file_info *const fileInfo);
+
+    /**
+     * FUSE low-level @c write callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    std::size_t write(const fuse_ino_t ino, asio::const_buffer buf,
+        const off_t offset, struct fuse_file_info *const fileInfo);
+
+    /**
+     * FUSE low-level @c flush callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void flush(const fuse_ino_t ino, struct fuse_file_info *const fileInfo);
+
+    /**
+     * FUSE low-level @c release callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void release(const fuse_ino_t ino, struct fuse_file_info *const fileInfo);
+
+    /**
+     * FUSE low-level @c fsync callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void fsync(const fuse_ino_t ino, const int datasync,
+        struct fuse_file_info *const fileInfo);
+
+    /**
+     * Lists names of entries of a directory for FUSE low-level @c opendir
+     * callback. The listing does not include "." and ".." entries.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    std::vector<std::string> readdir(const fuse_ino_t ino);
+
+    /**
+     * FUSE low-level @c statfs callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void statfs(const fuse_ino_t ino, struct statvfs *const statInfo);
+
+    /**
+     * FUSE low-level @c create callback.
+     * @see http://fuse.sourceforge.net/doxygen/structfuse__lowlevel__ops.html
+     */
+    void create(const fuse_ino_t parent, const std::string &name,
+        const mode_t mode, struct fuse_file_info *const fileInfo,
+        struct fuse_entry_param *const entry);
+
+    /**
+     * Lets the kernel cache file contents, attributes and directory entries
+     * of files accessed through the low-level interface. The kernel caches
+     * are invalidated whenever a remote change of a file is announced by an
+     * event.
+     * @param channel FUSE channel used to notify the kernel.
+     * @param timeout Time in seconds for which the kernel may cache
+     * attributes and directory entries.
+     */
+    void enableKernelCache(struct fuse_chan *channel, const double timeout);
+
+    /**
+     * @return Time in seconds for which the kernel may cache attributes
+     * returned by low-level callbacks.
+     */
+    double attrTimeout() const;
+
 protected:
     virtual HelpersCache::HelperPtr getHelper(
         const std::string &fileUuid, const std::string &storageId);
 
 private:
+    /**
+     * Children of a directory listed through the high-level interface,
+     * held in @c fuse_file_info::fh between @c opendir and @c releasedir
+     * calls.
+     */
+    struct DirectoryHandle {
+        /// Offset of the first child in @c names.
+        off_t offset = 0;
+        std::vector<std::string> names;
+        /// Whether @c names end the listing.
+        bool complete = false;
+    };
+
+    /**
+     * Children of a recently listed directory, whose attributes are
+     * prefetched once the first of them is looked up.
+     */
+    struct ListedDirectory {
+        std::string uuid;
+        std::vector<std::string> childUuids;
+        bool prefetching = false;
+    };
+
     void scheduleCacheExpirationTick();
+    void loadDirectoryCache();
+    void saveDirectoryCache();
+    std::string inodeToUuid(const fuse_ino_t ino);
+    boost::filesystem::path childPath(
+        const fuse_ino_t parent, const std::string &name);
+    fuse_ino_t lookupInode(const std::string &uuid);
+    void fillEntry(const fuse_ino_t parent, const std::string &name,
+        struct fuse_entry_param *const entry);
+    bool listChildren(const std::string &uuid,
+        const boost::filesystem::path &path, const off_t offset,
+        const std::size_t maxPages, std::vector<std::string> &names);
+    bool listCachedChildren(const std::string &uuid,
+        const boost::filesystem::path &path, std::vector<std::string> &names);
+    void updateListings(const boost::filesystem::path &oldPath,
+        const boost::optional<boost::filesystem::path> &newPath);
+    void rememberListedChildren(const std::string &dirUuid,
+        std::vector<std::string> childUuids, const bool restart);
+    void statAhead(const std::string &dirUuid);
+    void prefetchAttrs(std::vector<std::string> uuids);
+    void changeMode(const std::string &uuid, const mode_t mode);
+    void truncateFile(const std::string &uuid, const off_t newSize);
+    void updateTimes(const std::string &uuid, const std::time_t atime,
+        const std::time_t mtime);
+    std::size_t readFile(asio::mutable_buffer buf, const off_t offset,
+        struct fuse_file_info *const fileInfo);
+    std::size_t writeFile(asio::const_buffer buf, const off_t offset,
+        struct fuse_file_info *const fileInfo);
+    void releaseFile(struct fuse_file_info *const fileInfo);
     void removeFile(boost::filesystem::path path);
     const std::string createFile(
         boost::filesystem::path path, mode_t, const one::helpers::FlagsSet);
@@ -254,11 +452,18 @@ private:
         const std::string &uuid,
         const boost::icl::discrete_interval<off_t> &range,
         const one::helpers::FlagsSet flags);
+    void requestSyncAhead(const FileContextCache::FileContext &context,
+        const messages::fuse::FileLocation &location, const off_t offset,
+        const std::size_t size, const off_t fileSize);
     one::messages::fuse::Checksum syncAndFetchChecksum(const std::string &uuid,
         const boost::icl::discrete_interval<off_t> &range);
-    std::tuple<messages::fuse::FileBlock, asio::const_buffer> findWriteLocation(
-        const messages::fuse::FileLocation &fileLocation, const off_t offset,
-        const asio::const_buffer &buf);
+    bool publishWrites(const std::string &uuid);
+    void publishWrites(const std::string &uuid,
+        const std::shared_ptr<WriteAccumulator> &accumulator);
+    std::vector<std::pair<boost::icl::discrete_interval<off_t>,
+        messages::fuse::FileBlock>>
+    findWriteLocations(const messages::fuse::FileLocation &fileLocation,
+        const off_t offset, const std::size_t size);
     events::FileAttrEventStream::Handler fileAttrHandler();
     events::FileLocationEventStream::Handler fileLocationHandler();
     events::PermissionChangedEventStream::Handler permissionChangedHandler();
@@ -271,6 +476,8 @@ private:
         const boost::icl::discrete_interval<off_t> &wantedRange);
     std::string computeHash(asio::const_buffer buf);
     void disableSpaces(const std::vector<std::string> &spaces);
+    void invalidateKernelInode(const std::string &uuid, const bool data);
+    void invalidateKernelEntry(const boost::filesystem::path &path);
 
     const uid_t m_uid;
     const gid_t m_gid;
@@ -281,15 +488,54 @@ private:
     FileContextCache m_fileContextCache;
     HelpersCache m_helpersCache;
     MetadataCache m_metadataCache;
+    DirectoryCache m_directoryCache;
+    InodeCache m_inodeCache;
     FsSubscriptions m_fsSubscriptions;
     ForceProxyIOCache m_forceProxyIOCache;
     CacheExpirationHelper<std::string> m_locExpirationHelper;
     CacheExpirationHelper<std::string> m_attrExpirationHelper;
+    /// Tracks metadata cached only because the file has been listed
+    CacheExpirationHelper<std::string> m_listingExpirationHelper;
 
     std::mutex m_cancelCacheExpirationTickMutex;
     std::function<void()> m_cancelCacheExpirationTick;
+    std::size_t m_cacheExpirationTicks = 0;
     std::shared_timed_mutex m_disabledSpacesMutex;
     tbb::concurrent_unordered_set<std::string> m_disabledSpaces;
+
+    /// Write accumulators of open handles of a file, and the counter of them
+    /// with pending blocks shared by all open handles of the file
+    struct FileWrites {
+        std::vector<std::shared_ptr<WriteAccumulator>> accumulators;
+        std::shared_ptr<std::atomic<std::size_t>> pending =
+            std::make_shared<std::atomic<std::size_t>>(0);
+        std::size_t handles = 0;
+    };
+
+    /// Writes of open files, by file uuid
+    tbb::concurrent_hash_map<std::string, FileWrites> m_writeAccumulators;
+    using WriteAccumulatorsAccessor = decltype(m_writeAccumulators)::accessor;
+    using ConstWriteAccumulatorsAccessor =
+        decltype(m_writeAccumulators)::const_accessor;
+
+    asio::io_service m_ioService;
+    asio::executor_work<asio::io_service::executor_type> m_ioWork =
+        asio::make_work(m_ioService);
+    std::vector<std::thread> m_ioThreads;
+
+    asio::io_service m_prefetchService;
+    asio::executor_work<asio::io_service::executor_type> m_prefetchWork =
+        asio::make_work(m_prefetchService);
+    std::thread m_prefetchThread;
+
+    std::mutex m_listedDirectoriesMutex;
+    std::list<ListedDirectory> m_listedDirectories;
+    /// Number of listed directories whose children are not prefetched yet,
+    /// checked without locking before a lookup triggers prefetch.
+    std::atomic<std::size_t> m_pendingListedDirectories{0};
+
+    std::atomic<struct fuse_chan *> m_fuseChannel{nullptr};
+    double m_kernelCacheTimeout = 0;
 };
 
 struct FsLogicWrapper {
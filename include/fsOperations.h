@@ -10,7 +10,16 @@
 #define ONECLIENT_FS_OPERATIONS_H
 
 #include <fuse.h>
+#include <fuse/fuse_lowlevel.h>
 
+/**
+ * @return Path-based FUSE operations.
+ */
 struct fuse_operations fuseOperations();
 
+/**
+ * @return Inode-based FUSE low-level operations.
+ */
+struct fuse_lowlevel_ops fuseLowLevelOperations();
+
 #endif // ONECLIENT_FS_OPERATIONS_H
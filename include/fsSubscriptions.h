@@ -9,10 +9,15 @@
 #ifndef ONECLIENT_FS_SUBSCRIPTIONS_H
 #define ONECLIENT_FS_SUBSCRIPTIONS_H
 
+#include "events/subscriptionQueue.h"
+
 #include <tbb/concurrent_hash_map.h>
 
 #include <chrono>
 #include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 
 namespace one {
@@ -24,13 +29,33 @@ class EventManager;
 
 constexpr std::chrono::seconds FILE_ATTR_SUBSCRIPTION_DURATION{30};
 
+/**
+ * @c FsSubscriptions manages subscriptions for changes of files on the server.
+ * Subscriptions are sent immediately. Cancellations of file attributes,
+ * removal, renaming and permission changes subscriptions can be queued and
+ * sent periodically, so that cancellations of files subscribed again before
+ * the next flush are never sent.
+ */
 class FsSubscriptions {
 public:
     /**
      * Constructor.
      * @param eventManager @c EventManager instance.
+     * @param scheduler @c Scheduler instance used to flush queued
+     * cancellations.
+     * @param flushInterval Interval between flushes of queued cancellations.
+     * Cancellations are sent immediately if it is zero or the scheduler is not
+     * provided.
+     */
+    FsSubscriptions(events::EventManager &eventManager,
+        std::shared_ptr<Scheduler> scheduler = {},
+        std::chrono::milliseconds flushInterval = std::chrono::milliseconds{0});
+
+    /**
+     * Destructor.
+     * Stops flushing queued cancellations.
      */
-    FsSubscriptions(events::EventManager &eventManager);
+    virtual ~FsSubscriptions();
 
     /**
      * Adds subscription for file location updates. Subscription of the
@@ -111,7 +136,14 @@ public:
      */
     void removeQuotaSubscription();
 
+    /**
+     * Sends queued subscription cancellations to the server.
+     */
+    void flush();
+
 private:
+    void scheduleFlush();
+
     std::int64_t sendFileAttrSubscription(const std::string &fileUuid);
     std::int64_t sendFileLocationSubscription(const std::string &fileUuid);
     std::int64_t sendPermissionChangedSubscription(const std::string &fileUuid);
@@ -121,15 +153,19 @@ private:
     void sendSubscriptionCancellation(std::int64_t id);
 
     events::EventManager &m_eventManager;
-    tbb::concurrent_hash_map<std::string, std::int64_t> m_fileAttrSubscriptions;
+    std::shared_ptr<Scheduler> m_scheduler;
+    const std::chrono::milliseconds m_flushInterval;
+    const bool m_deferred = m_scheduler && m_flushInterval.count() > 0;
+
+    events::SubscriptionQueue m_fileAttrSubscriptions;
     tbb::concurrent_hash_map<std::string, std::int64_t>
         m_fileLocationSubscriptions;
-    tbb::concurrent_hash_map<std::string, std::int64_t>
-        m_permissionChangedSubscriptions;
-    tbb::concurrent_hash_map<std::string, std::int64_t>
-        m_fileRemovalSubscriptions;
-    tbb::concurrent_hash_map<std::string, std::int64_t>
-        m_fileRenamedSubscriptions;
+    events::SubscriptionQueue m_permissionChangedSubscriptions;
+    events::SubscriptionQueue m_fileRemovalSubscriptions;
+    events::SubscriptionQueue m_fileRenamedSubscriptions;
+
+    std::mutex m_cancelFlushMutex;
+    std::function<void()> m_cancelFlush = [] {};
 
     std::int64_t m_quotaSubscription = 0;
 };
@@ -199,10 +199,22 @@ private:
     DECL_CONFIG(fuse_id, std::string)
     DECL_CONFIG_DEF(cluster_ping_interval, std::time_t, 60)
     DECL_CONFIG_DEF(jobscheduler_threads, unsigned int, 3)
+    DECL_CONFIG_DEF(io_threads, unsigned int, 8)
+    DECL_CONFIG_DEF(event_threads, unsigned int, 2)
+    DECL_CONFIG_DEF(write_event_max_blocks, std::size_t, 4096)
+    DECL_CONFIG_DEF(write_event_coalesce_blocks, std::size_t, 1024)
+    DECL_CONFIG_DEF(write_event_coalesce_gap, std::size_t, 0)
+    DECL_CONFIG_DEF(event_stream_buffer_max_size, std::size_t, 16 * 1024 * 1024) // 16 MB
+    DECL_CONFIG_DEF(subscriptions_flush_interval, unsigned int, 100)
     DECL_CONFIG_DEF(alive_meta_connections_count, unsigned int, 2)
     DECL_CONFIG_DEF(alive_data_connections_count, unsigned int, 2)
     DECL_CONFIG_DEF(enable_dir_prefetch, bool, true)
     DECL_CONFIG_DEF(enable_parallel_getattr, bool, true)
+    DECL_CONFIG_DEF(dir_cache_max_entries, std::size_t, 100000)
+    DECL_CONFIG_DEF(negative_cache_max_entries, std::size_t, 10000)
+    DECL_CONFIG_DEF(metadata_cache_max_entries, std::size_t, 500000)
+    DECL_CONFIG_DEF(metadata_cache_max_size, std::size_t, 512 * 1024 * 1024) // 512 MB
+    DECL_CONFIG(metadata_cache_file, std::string)
     DECL_CONFIG_DEF(enable_permission_checking, bool, false)
     DECL_CONFIG_DEF(write_buffer_max_size, std::size_t, 64 * 1024 * 1024) // 64 MB
     DECL_CONFIG_DEF(read_buffer_max_size, std::size_t, 10 * 1024 * 1024) // 10 MB
@@ -210,6 +222,8 @@ private:
     DECL_CONFIG_DEF(read_buffer_max_file_size, std::size_t, 10 * 1024 * 1024) // 10 MB
     DECL_CONFIG_DEF(file_buffer_prefered_block_size, std::size_t, 100 * 1024) // 100 kB
     DECL_CONFIG_DEF(file_sync_timeout, std::time_t, 300)
+    DECL_CONFIG_DEF(sync_ahead_min_size, std::size_t, 1024 * 1024) // 1 MB
+    DECL_CONFIG_DEF(sync_ahead_max_size, std::size_t, 64 * 1024 * 1024) // 64 MB
     DECL_CONFIG_DEF(write_bytes_before_stat, std::size_t, 5 * 1024 * 1024) // 5 MB
     DECL_CONFIG(fuse_group_id, std::string)
     DECL_CONFIG_DEF(global_registry_url, std::string, "onedata.org")
@@ -221,6 +235,9 @@ private:
     DECL_CMDLINE_SWITCH_DEF(help, ",h", false, "print help")
     DECL_CMDLINE_SWITCH_DEF(version, ",V", false, "print version")
     DECL_CMDLINE_SWITCH_DEF(proxyio, "", false, "force ProxyIO")
+    DECL_CMDLINE_SWITCH_DEF(low_level_fuse, "", false, "use inode-based FUSE low-level interface")
+    DECL_CMDLINE_SWITCH_DEF(kernel_cache, "", false, "let the kernel cache file contents and attributes (requires --low_level_fuse)")
+    DECL_CONFIG_DEF(kernel_cache_timeout, double, 10.0)
     DECL_CONFIG_DESC(config, std::string, "path to user config file")
     DECL_CONFIG_DEF(enable_env_option_override, bool, true)
     DECL_REQ_CONFIG(mountpoint, std::string)
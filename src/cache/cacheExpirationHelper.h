@@ -14,11 +14,12 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
-#include <functional>
-#include <memory>
+#include <cstddef>
+#include <iterator>
+#include <limits>
 #include <mutex>
 #include <shared_mutex>
-#include <string>
+#include <vector>
 
 namespace one {
 namespace client {
@@ -26,86 +27,111 @@ namespace client {
 /**
  * @c CacheExpirationHelper keeps track of expiration of arbitrary elements
  * identified by a key.
+ * Unpinned elements are kept on a two-level timing wheel. A touch of an
+ * element only moves its deadline; the element is moved on the wheel lazily,
+ * when its slot comes due before the deadline. Thus each call to @c tick()
+ * only visits elements whose wheel slot has come due, and an element busy
+ * with touches is moved at most once per its time to live.
  * @tparam Key Type of the cache record's key.
- * @tparam BucketsCount Number of cache buckets. An unpinned entry and unused
- * will expire after @c BucketsCount calls to @c tick().
+ * @tparam DefaultTtl Number of calls to @c tick() after which an unpinned
+ * and unused entry expires, unless a different time to live is given.
  * @tparam HashCompare Comparator used to hash and compare objects of @c Key
  * type.
  */
-template <typename Key, std::size_t BucketsCount = 30,
+template <typename Key, std::size_t DefaultTtl = 30,
     class HashCompare = tbb::tbb_hash_compare<Key>>
 class CacheExpirationHelper {
     static_assert(
-        BucketsCount > 0, "CacheExpirationHelper needs at least one bucket");
+        DefaultTtl > 0, "CacheExpirationHelper needs a positive time to live");
 
 public:
     /**
-     * Constructor.
-     * Initializes buckets.
+     * Advances time by one tick.
+     * Elements whose deadline has been reached are considered to be expired.
+     * @param purge Callable that ensures an element is removed from a cache.
+     * It takes one argument of type @c Key . @c purge will be called for every
+     * entry that is considered to be expired.
      */
-    CacheExpirationHelper()
+    template <typename PurgeFun> void tick(PurgeFun &&purge)
     {
-        for (auto &bucket : m_buckets)
-            bucket = std::make_unique<Set>();
+        std::vector<Key> due;
+        std::vector<Key> cascaded;
+        std::size_t now;
+        {
+            std::lock_guard<decltype(m_mutex)> guard{m_mutex};
+            now = ++m_now;
+            take(m_wheel[0][now % WHEEL_SLOTS], due);
+            if (now % WHEEL_SLOTS == 0)
+                take(m_wheel[1][(now / WHEEL_SLOTS) % WHEEL_SLOTS], cascaded);
+        }
+
+        process(due, now, purge);
+        process(cascaded, now, purge);
     }
 
     /**
-     * Moves elements to the next bucket (closer to expiration).
-     * Elements in the last bucket before the call to @c tick() are considered
-     * to be expired.
-     * @param purge Callable that ensures an element is removed from a cache.
-     * It takes one argument of type @c Key . @c purge will be called for every
-     * entry that is considered to be expired.
+     * Expires the least recently used unpinned records, in the order of their
+     * deadlines, until the cache is no longer over its limit or no unpinned
+     * record is left. Unlike @c tick(), does not advance time, so the time
+     * to live of the remaining records is not shortened.
+     * Must not be called concurrently with @c tick().
+     * @param purge Callable that ensures an element is removed from a cache,
+     * as in @c tick().
+     * @param overLimit Callable taking no arguments, returning true while the
+     * cache is over its limit.
      */
-    template <typename PurgeFun> void tick(PurgeFun &&purge)
+    template <typename PurgeFun, typename OverLimitFun>
+    void evict(PurgeFun &&purge, OverLimitFun &&overLimit)
     {
-        auto expiredBucket = shift();
-        for (auto &elem : *expiredBucket) {
-            typename decltype(m_expDetails)::accessor acc;
+        std::size_t now;
+        {
+            std::shared_lock<decltype(m_mutex)> lock{m_mutex};
+            now = m_now;
+        }
 
-            if (m_expDetails.find(acc, elem.first) &&
-                acc->second.bucket == expiredBucket.get()) {
-                purge(elem.first);
-                m_expDetails.erase(acc);
-            }
+        for (std::size_t i = 1; i < WHEEL_SLOTS && overLimit(); ++i)
+            evictSlot(m_wheel[0][(now + i) % WHEEL_SLOTS], now + i, now,
+                purge, overLimit);
+
+        for (std::size_t i = 1; i < WHEEL_SLOTS && overLimit(); ++i) {
+            const auto round = now / WHEEL_SLOTS + i;
+            evictSlot(m_wheel[1][round % WHEEL_SLOTS], round * WHEEL_SLOTS,
+                now, purge, overLimit);
         }
     }
 
     /**
      * Marks a record as "interesting".
-     * An interesting, unpinned record will be put into the first bucket
-     * (furthest from expiration).
+     * An interesting, unpinned record will expire after @p ttl ticks.
      * @param key The key of the interesting record.
      * @param cache Callable taking no arguments, that ensures the element is in
      * the cache. It will only be called if the element was not already tracked
      * by @c *this .
+     * @param ttl Number of ticks after which the record expires once it is
+     * unpinned and unused.
      */
     template <typename CacheFun>
-    void markInteresting(const Key &key, CacheFun &&cache)
+    void markInteresting(
+        const Key &key, CacheFun &&cache, const std::size_t ttl = DefaultTtl)
     {
+        assert(ttl > 0);
         std::shared_lock<decltype(m_mutex)> lock{m_mutex};
 
-        typename decltype(m_expDetails)::accessor acc;
+        typename Details::accessor acc;
         if (m_expDetails.insert(acc, key))
             cache();
 
-        if (acc->second.pinnedCount == 0 &&
-            acc->second.bucket != m_buckets.back().get()) {
-            if (acc->second.bucket)
-                acc->second.bucket->erase(key);
-
-            acc->second.bucket = m_buckets.back().get();
-
-            typename Set::const_accessor sacc;
-            if (!m_buckets.back()->insert(sacc, key))
-                assert(false);
-        }
+        auto &details = acc->second;
+        details.ttl = ttl;
+        details.deadline = m_now + ttl;
+        if (details.pinnedCount == 0 && details.wheelTick > details.deadline)
+            schedule(key, details, m_now);
     }
 
     /**
      * Marks a record as "pinned".
-     * A pinned record will not be put into any bucket. Every call to @c pin()
-     * should be matched by a later call to @c unpin().
+     * A pinned record will not expire. Every call to @c pin() should be
+     * matched by a later call to @c unpin().
      * @param key The key of the pinned record.
      * @param cache Callable taking no arguments, that ensures the element is in
      * the cache. It will only be called if the element was not already tracked
@@ -115,45 +141,42 @@ public:
     {
         std::shared_lock<decltype(m_mutex)> lock{m_mutex};
 
-        typename decltype(m_expDetails)::accessor acc;
+        typename Details::accessor acc;
         if (m_expDetails.insert(acc, key))
             cache();
 
-        if (acc->second.bucket) {
-            acc->second.bucket->erase(key);
-            acc->second.bucket = nullptr;
-        }
-
+        // The record stays on the wheel until its slot comes due, so that
+        // a short pin does not have to move it
         ++acc->second.pinnedCount;
     }
 
     /**
      * Unpins a record.
-     * If the record is no longer pinned, it will be put into the first bucket
-     * (furthest from expiration).
+     * If the record is no longer pinned, it will expire after its time to
+     * live.
      * @param key The key of the pinned record.
      */
     void unpin(const Key &key)
     {
         std::shared_lock<decltype(m_mutex)> lock{m_mutex};
 
-        typename decltype(m_expDetails)::accessor acc;
+        typename Details::accessor acc;
         if (!m_expDetails.find(acc, key))
             assert(false);
 
-        assert(!acc->second.bucket);
+        auto &details = acc->second;
+        assert(details.pinnedCount > 0);
 
-        if (--acc->second.pinnedCount == 0) {
-            acc->second.bucket = m_buckets.back().get();
-            typename Set::const_accessor sacc;
-            if (!acc->second.bucket->insert(sacc, key))
-                assert(false);
+        if (--details.pinnedCount == 0) {
+            details.deadline = m_now + details.ttl;
+            if (details.wheelTick > details.deadline)
+                schedule(key, details, m_now);
         }
     }
 
     /**
      * Renames a record.
-     * Renamed record will retain bucket and pins count.
+     * Renamed record will retain its deadline, time to live and pins count.
      * @param key The old key of the renamed record.
      * @param key The new key of the renamed record.
      * @param cache Callable taking no arguments, that ensures the element is in
@@ -167,8 +190,8 @@ public:
             return;
         std::shared_lock<decltype(m_mutex)> lock{m_mutex};
 
-        typename decltype(m_expDetails)::accessor oldAcc;
-        typename decltype(m_expDetails)::accessor newAcc;
+        typename Details::accessor oldAcc;
+        typename Details::accessor newAcc;
 
         auto newKeyTracked = false;
         // Always take locks in fixed order, to avoid deadlock
@@ -190,24 +213,18 @@ public:
 
         if (newKeyTracked) {
             newAcc->second.pinnedCount += oldAcc->second.pinnedCount;
-            if (newAcc->second.pinnedCount > 0 && newAcc->second.bucket) {
-                newAcc->second.bucket->erase(newKey);
-                newAcc->second.bucket = nullptr;
-            }
         }
         else {
             cache();
-            newAcc->second.pinnedCount = oldAcc->second.pinnedCount;
-            if (newAcc->second.pinnedCount == 0) {
-                typename Set::const_accessor sacc;
-                if (!oldAcc->second.bucket->insert(sacc, newKey))
-                    assert(false);
-                newAcc->second.bucket = oldAcc->second.bucket;
-            }
+            auto &details = newAcc->second;
+            details = oldAcc->second;
+            details.wheelTick = UNSCHEDULED;
+            details.deadline = std::max(details.deadline, m_now + 1);
+            if (details.pinnedCount == 0)
+                schedule(newKey, details, m_now);
         }
 
-        if (oldAcc->second.bucket)
-            oldAcc->second.bucket->erase(oldKey);
+        // Wheel entries of the old key are skipped once it is untracked
         m_expDetails.erase(oldAcc);
     }
 
@@ -218,47 +235,169 @@ public:
     {
         std::shared_lock<decltype(m_mutex)> lock{m_mutex};
 
-        typename decltype(m_expDetails)::accessor acc;
+        typename Details::accessor acc;
         if (!m_expDetails.find(acc, key) || acc->second.pinnedCount > 0)
             return;
 
-        assert(acc->second.bucket);
+        auto &details = acc->second;
+        details.deadline = m_now + 1;
+        if (details.wheelTick != details.deadline)
+            schedule(key, details, m_now);
+    }
 
-        if (acc->second.bucket != m_buckets.front().get()) {
-            acc->second.bucket->erase(key);
-            acc->second.bucket = m_buckets.front().get();
+    /**
+     * Stops tracking a record, regardless of its pins.
+     * The record's wheel entries are skipped once it is untracked. Must not
+     * be called from a @c purge callback for the purged key.
+     * @param key The key of the forgotten record.
+     */
+    void forget(const Key &key)
+    {
+        typename Details::accessor acc;
+        if (m_expDetails.find(acc, key))
+            m_expDetails.erase(acc);
+    }
 
-            typename Set::const_accessor sacc;
-            if (!m_buckets.front()->insert(sacc, key))
-                assert(false);
-        }
+    /**
+     * @param key The key of a record.
+     * @return true if the record is tracked by @c *this .
+     */
+    bool tracked(const Key &key) const
+    {
+        typename Details::const_accessor constAcc;
+        return m_expDetails.find(constAcc, key);
     }
 
 private:
-    auto shift()
+    /// Number of slots on each level of the wheel. The first level holds
+    /// records due within @c WHEEL_SLOTS ticks, one slot per tick; the second
+    /// level holds later records, one slot per @c WHEEL_SLOTS ticks.
+    static constexpr std::size_t WHEEL_SLOTS = 64;
+
+    /// Wheel tick of records not placed on the wheel.
+    static constexpr std::size_t UNSCHEDULED =
+        std::numeric_limits<std::size_t>::max();
+
+    struct ExpirationDetails {
+        std::size_t pinnedCount = 0;
+        std::size_t ttl = DefaultTtl;
+        /// Tick at which the record expires, if unpinned.
+        std::size_t deadline = 0;
+        /// Tick at which the wheel slot holding the record comes due.
+        std::size_t wheelTick = UNSCHEDULED;
+    };
+
+    struct Slot {
+        std::mutex mutex;
+        std::vector<Key> keys;
+    };
+
+    using Details =
+        tbb::concurrent_hash_map<Key, ExpirationDetails, HashCompare>;
+
+    void take(Slot &slot, std::vector<Key> &keys)
     {
-        std::lock_guard<decltype(m_mutex)> guard{m_mutex};
+        std::lock_guard<std::mutex> guard{slot.mutex};
+        keys.swap(slot.keys);
+    }
 
-        auto expiredBucket = std::move(m_buckets.front());
+    /**
+     * Places a record on the wheel, in the slot coming due at its deadline
+     * or at the last second level slot before it. Any previous wheel entry
+     * of the record becomes stale and is skipped when its slot comes due.
+     * Must be called with @c m_now fixed and the record's accessor held.
+     */
+    void schedule(
+        const Key &key, ExpirationDetails &details, const std::size_t now)
+    {
+        assert(details.deadline > now);
 
-        std::move(m_buckets.begin() + 1, m_buckets.end(), m_buckets.begin());
-        m_buckets.back() = std::make_unique<Set>();
+        Slot *slot;
+        if (details.deadline - now < WHEEL_SLOTS) {
+            details.wheelTick = details.deadline;
+            slot = &m_wheel[0][details.wheelTick % WHEEL_SLOTS];
+        }
+        else {
+            const auto round = std::min(details.deadline / WHEEL_SLOTS,
+                now / WHEEL_SLOTS + WHEEL_SLOTS - 1);
+            details.wheelTick = round * WHEEL_SLOTS;
+            slot = &m_wheel[1][round % WHEEL_SLOTS];
+        }
+
+        std::lock_guard<std::mutex> guard{slot->mutex};
+        slot->keys.emplace_back(key);
+    }
 
-        return expiredBucket;
+    /**
+     * Expires or reschedules records from a slot that has come due.
+     */
+    template <typename PurgeFun>
+    void process(
+        const std::vector<Key> &keys, const std::size_t now, PurgeFun &purge)
+    {
+        for (const auto &key : keys) {
+            typename Details::accessor acc;
+            if (!m_expDetails.find(acc, key) || acc->second.wheelTick != now)
+                continue;
+
+            auto &details = acc->second;
+            if (details.pinnedCount > 0) {
+                details.wheelTick = UNSCHEDULED;
+            }
+            else if (details.deadline > now) {
+                schedule(key, details, now);
+            }
+            else {
+                purge(key);
+                m_expDetails.erase(acc);
+            }
+        }
     }
 
-    // concurrent_hash_map, as opposed to concurrent_unordered_set, permits
-    // concurrent erasure
-    using Set = tbb::concurrent_hash_map<Key, char, HashCompare>;
+    /**
+     * Expires unpinned records from a slot ahead of time, until the cache is
+     * no longer over its limit. Records touched since they were placed in
+     * the slot are moved to the slot of their deadline instead. Records not
+     * visited are left in the slot.
+     */
+    template <typename PurgeFun, typename OverLimitFun>
+    void evictSlot(Slot &slot, const std::size_t wheelTick,
+        const std::size_t now, PurgeFun &purge, OverLimitFun &overLimit)
+    {
+        std::vector<Key> keys;
+        take(slot, keys);
+
+        auto it = keys.begin();
+        for (; it != keys.end() && overLimit(); ++it) {
+            typename Details::accessor acc;
+            if (!m_expDetails.find(acc, *it) ||
+                acc->second.wheelTick != wheelTick)
+                continue;
+
+            auto &details = acc->second;
+            if (details.pinnedCount > 0) {
+                details.wheelTick = UNSCHEDULED;
+            }
+            else if (details.deadline > wheelTick) {
+                schedule(*it, details, now);
+            }
+            else {
+                purge(*it);
+                m_expDetails.erase(acc);
+            }
+        }
 
-    struct ExpirationDetails {
-        std::size_t pinnedCount = 0;
-        Set *bucket = nullptr;
-    };
+        std::lock_guard<std::mutex> guard{slot.mutex};
+        slot.keys.insert(slot.keys.end(), std::make_move_iterator(it),
+            std::make_move_iterator(keys.end()));
+    }
 
+    /// Exclusively locked only to advance time; shared by operations reading
+    /// the current tick, so that it stays fixed while they place records.
     std::shared_timed_mutex m_mutex;
-    tbb::concurrent_hash_map<Key, ExpirationDetails, HashCompare> m_expDetails;
-    std::array<std::unique_ptr<Set>, BucketsCount> m_buckets;
+    std::size_t m_now = 0;
+    Details m_expDetails;
+    std::array<std::array<Slot, WHEEL_SLOTS>, 2> m_wheel;
 };
 
 } // namespace client
@@ -0,0 +1,494 @@
+/**
+ * @file directoryCache.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "directoryCache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+namespace {
+
+/**
+ * Modification times are reported with a resolution of one second, so a
+ * listing taken within the second its directory was modified in may miss
+ * the modification and cannot be revalidated.
+ */
+constexpr std::chrono::seconds MTIME_RESOLUTION{1};
+
+constexpr char CACHE_FILE_MAGIC[8] = {'O', 'N', 'E', 'D', 'I', 'R', 'C', 'A'};
+constexpr std::uint32_t CACHE_FILE_VERSION = 1;
+
+std::system_error systemError(const std::string &what)
+{
+    return std::system_error{errno, std::system_category(), what};
+}
+
+/**
+ * 64-bit FNV-1a hash guarding the cache file against torn writes.
+ */
+std::uint64_t checksum(const char *data, const std::size_t size)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// The cache file is local to the host, so integers are stored in its native
+// byte order
+template <typename T> void append(std::string &out, const T value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void append(std::string &out, const std::string &value)
+{
+    append<std::uint32_t>(out, value.size());
+    out.append(value);
+}
+
+class Reader {
+public:
+    Reader(const char *begin, const char *end)
+        : m_pos{begin}
+        , m_end{end}
+    {
+    }
+
+    template <typename T> bool read(T &value)
+    {
+        if (static_cast<std::size_t>(m_end - m_pos) < sizeof(value))
+            return false;
+
+        std::memcpy(&value, m_pos, sizeof(value));
+        m_pos += sizeof(value);
+        return true;
+    }
+
+    bool read(std::string &value)
+    {
+        std::uint32_t size;
+        if (!read(size) || static_cast<std::size_t>(m_end - m_pos) < size)
+            return false;
+
+        value.assign(m_pos, size);
+        m_pos += size;
+        return true;
+    }
+
+    bool done() const { return m_pos == m_end; }
+
+private:
+    const char *m_pos;
+    const char *const m_end;
+};
+
+void writeAll(const int fd, const std::string &data)
+{
+    std::size_t written = 0;
+    while (written < data.size()) {
+        auto res = ::write(fd, data.data() + written, data.size() - written);
+        if (res < 0 && errno == EINTR)
+            continue;
+        if (res < 0)
+            throw systemError("write");
+
+        written += res;
+    }
+}
+
+} // namespace
+
+namespace one {
+namespace client {
+
+DirectoryCache::DirectoryCache(const std::size_t maxEntries)
+    : m_maxEntries{maxEntries}
+{
+}
+
+boost::optional<DirectoryCache::Children> DirectoryCache::get(
+    const std::string &dirUuid)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    auto it = m_listings.find(dirUuid);
+    if (it == m_listings.end())
+        return {};
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+    return it->second.children;
+}
+
+void DirectoryCache::put(const std::string &dirUuid, Children children,
+    Clock::time_point mtime)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    ++m_version;
+
+    eraseUnverified(dirUuid);
+    auto it = m_listings.find(dirUuid);
+    if (it != m_listings.end())
+        erase(it);
+
+    if (children.size() > m_maxEntries)
+        return;
+
+    evict(children.size(), dirUuid);
+
+    Listing listing;
+    for (auto &child : children) {
+        auto position = listing.positions.find(std::get<1>(child));
+        if (position != listing.positions.end()) {
+            listing.children[position->second] = std::move(child);
+        }
+        else {
+            listing.positions.emplace(
+                std::get<1>(child), listing.children.size());
+            listing.children.emplace_back(std::move(child));
+        }
+    }
+
+    if (mtime != Clock::time_point{} &&
+        mtime + MTIME_RESOLUTION < Clock::now())
+        listing.mtime = mtime;
+
+    m_entries += listing.children.size();
+    m_lru.emplace_front(dirUuid);
+    listing.lruPosition = m_lru.begin();
+    m_listings.emplace(dirUuid, std::move(listing));
+}
+
+void DirectoryCache::addChild(
+    const std::string &dirUuid, std::string uuid, std::string name)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    ++m_version;
+
+    eraseUnverified(dirUuid);
+    auto it = m_listings.find(dirUuid);
+    if (it == m_listings.end())
+        return;
+
+    auto &listing = it->second;
+    auto position = listing.positions.find(name);
+    if (position != listing.positions.end()) {
+        std::get<0>(listing.children[position->second]) = std::move(uuid);
+        return;
+    }
+
+    evict(1, dirUuid);
+    if (m_entries + 1 > m_maxEntries) {
+        erase(it);
+        return;
+    }
+
+    listing.positions.emplace(name, listing.children.size());
+    listing.children.emplace_back(std::move(uuid), std::move(name));
+    ++m_entries;
+}
+
+void DirectoryCache::removeChild(
+    const std::string &dirUuid, const std::string &name)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    ++m_version;
+
+    eraseUnverified(dirUuid);
+    auto it = m_listings.find(dirUuid);
+    if (it == m_listings.end())
+        return;
+
+    auto &listing = it->second;
+    auto position = listing.positions.find(name);
+    if (position == listing.positions.end())
+        return;
+
+    // The order of children is not significant, so the last child takes
+    // place of the removed one
+    const auto index = position->second;
+    listing.positions.erase(position);
+
+    if (index != listing.children.size() - 1) {
+        listing.children[index] = std::move(listing.children.back());
+        listing.positions[std::get<1>(listing.children[index])] = index;
+    }
+
+    listing.children.pop_back();
+    --m_entries;
+}
+
+void DirectoryCache::invalidate(const std::string &dirUuid)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    ++m_version;
+
+    eraseUnverified(dirUuid);
+    auto it = m_listings.find(dirUuid);
+    if (it != m_listings.end())
+        erase(it);
+}
+
+void DirectoryCache::retire(const std::string &dirUuid)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    ++m_version;
+
+    auto it = m_listings.find(dirUuid);
+    if (it == m_listings.end())
+        return;
+
+    UnverifiedListing listing{std::move(it->second.children), it->second.mtime};
+    m_entries -= listing.children.size();
+    erase(it);
+
+    if (listing.mtime != Clock::time_point{})
+        putUnverified(dirUuid, std::move(listing));
+}
+
+bool DirectoryCache::revalidate(
+    const std::string &dirUuid, Clock::time_point mtime)
+{
+    UnverifiedListing listing;
+    {
+        std::lock_guard<std::mutex> guard{m_mutex};
+
+        auto it = m_unverified.find(dirUuid);
+        if (it == m_unverified.end())
+            return false;
+
+        listing = std::move(it->second);
+        m_unverifiedEntries -= listing.children.size();
+        m_unverified.erase(it);
+        ++m_version;
+    }
+
+    if (listing.mtime != mtime)
+        return false;
+
+    put(dirUuid, std::move(listing.children), listing.mtime);
+    return true;
+}
+
+bool DirectoryCache::save(const boost::filesystem::path &file)
+{
+    // Listings are only copied under the lock, so that serializing and
+    // writing them out does not hold up lookups and updates
+    std::vector<std::pair<std::string, UnverifiedListing>> listings;
+    std::uint64_t version;
+    {
+        std::lock_guard<std::mutex> guard{m_mutex};
+        if (m_version == m_savedVersion)
+            return false;
+
+        version = m_version;
+        listings.reserve(m_listings.size() + m_unverified.size());
+        for (const auto &entry : m_listings)
+            if (entry.second.mtime != Clock::time_point{})
+                listings.emplace_back(entry.first,
+                    UnverifiedListing{
+                        entry.second.children, entry.second.mtime});
+
+        for (const auto &entry : m_unverified)
+            listings.emplace_back(entry.first, entry.second);
+    }
+
+    std::string data{CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC)};
+    append(data, CACHE_FILE_VERSION);
+    for (const auto &entry : listings) {
+        append(data, entry.first);
+        append<std::int64_t>(data, Clock::to_time_t(entry.second.mtime));
+        append<std::uint64_t>(data, entry.second.children.size());
+        for (const auto &child : entry.second.children) {
+            append(data, std::get<0>(child));
+            append(data, std::get<1>(child));
+        }
+    }
+
+    append(data, checksum(data.data(), data.size()));
+
+    // The previous file stays in place until the new one is complete, so a
+    // crash leaves either of them behind
+    const auto tmpFile = file.string() + ".tmp";
+    const int fd = ::open(tmpFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0)
+        throw systemError("open " + tmpFile);
+
+    try {
+        writeAll(fd, data);
+        if (::fsync(fd) < 0)
+            throw systemError("fsync " + tmpFile);
+    }
+    catch (...) {
+        ::close(fd);
+        ::unlink(tmpFile.c_str());
+        throw;
+    }
+
+    ::close(fd);
+    if (::rename(tmpFile.c_str(), file.c_str()) < 0) {
+        auto error = systemError("rename " + tmpFile);
+        ::unlink(tmpFile.c_str());
+        throw error;
+    }
+
+    std::lock_guard<std::mutex> guard{m_mutex};
+    m_savedVersion = version;
+    return true;
+}
+
+std::size_t DirectoryCache::load(const boost::filesystem::path &file)
+{
+    const int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0 && errno == ENOENT)
+        return 0;
+    if (fd < 0)
+        throw systemError("open " + file.string());
+
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        auto error = systemError("fstat " + file.string());
+        ::close(fd);
+        throw error;
+    }
+
+    const auto size = static_cast<std::size_t>(st.st_size);
+    const auto minSize = sizeof(CACHE_FILE_MAGIC) +
+        sizeof(CACHE_FILE_VERSION) + sizeof(std::uint64_t);
+    if (size < minSize) {
+        ::close(fd);
+        return 0;
+    }
+
+    void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        throw systemError("mmap " + file.string());
+
+    const auto begin = static_cast<const char *>(mapping);
+    const auto end = begin + size - sizeof(std::uint64_t);
+
+    std::uint64_t expectedChecksum;
+    std::memcpy(&expectedChecksum, end, sizeof(expectedChecksum));
+
+    std::uint32_t version = 0;
+    Reader reader{begin + sizeof(CACHE_FILE_MAGIC), end};
+    if (std::memcmp(begin, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC)) != 0 ||
+        !reader.read(version) || version != CACHE_FILE_VERSION ||
+        checksum(begin, end - begin) != expectedChecksum) {
+        ::munmap(mapping, size);
+        return 0;
+    }
+
+    std::vector<std::pair<std::string, UnverifiedListing>> listings;
+    while (!reader.done()) {
+        std::string dirUuid;
+        std::int64_t mtime;
+        std::uint64_t childrenNo;
+        if (!reader.read(dirUuid) || !reader.read(mtime) ||
+            !reader.read(childrenNo))
+            break;
+
+        UnverifiedListing listing;
+        listing.mtime = Clock::from_time_t(mtime);
+        for (std::uint64_t i = 0; i < childrenNo; ++i) {
+            std::string uuid, name;
+            if (!reader.read(uuid) || !reader.read(name))
+                break;
+
+            listing.children.emplace_back(std::move(uuid), std::move(name));
+        }
+
+        if (listing.children.size() != childrenNo)
+            break;
+
+        listings.emplace_back(std::move(dirUuid), std::move(listing));
+    }
+
+    ::munmap(mapping, size);
+    if (!reader.done())
+        return 0;
+
+    std::lock_guard<std::mutex> guard{m_mutex};
+    std::size_t loaded = 0;
+    for (auto &entry : listings) {
+        if (m_listings.count(entry.first))
+            continue;
+
+        eraseUnverified(entry.first);
+        putUnverified(entry.first, std::move(entry.second));
+        loaded += m_unverified.count(entry.first);
+    }
+
+    return loaded;
+}
+
+std::size_t DirectoryCache::size() const
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    return m_entries;
+}
+
+std::size_t DirectoryCache::unverifiedSize() const
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    return m_unverifiedEntries;
+}
+
+std::list<std::string>::iterator DirectoryCache::erase(
+    std::unordered_map<std::string, Listing>::iterator it)
+{
+    m_entries -= it->second.children.size();
+    auto next = m_lru.erase(it->second.lruPosition);
+    m_listings.erase(it);
+    return next;
+}
+
+void DirectoryCache::evict(
+    const std::size_t required, const std::string &keptUuid)
+{
+    auto it = m_lru.end();
+    while (it != m_lru.begin() && m_entries + required > m_maxEntries) {
+        --it;
+        if (*it != keptUuid)
+            it = erase(m_listings.find(*it));
+    }
+}
+
+void DirectoryCache::putUnverified(
+    const std::string &dirUuid, UnverifiedListing listing)
+{
+    // Unverified listings are only a hint, so the ones that do not fit are
+    // simply dropped
+    if (m_unverifiedEntries + listing.children.size() > m_maxEntries)
+        return;
+
+    m_unverifiedEntries += listing.children.size();
+    m_unverified[dirUuid] = std::move(listing);
+}
+
+void DirectoryCache::eraseUnverified(const std::string &dirUuid)
+{
+    auto it = m_unverified.find(dirUuid);
+    if (it == m_unverified.end())
+        return;
+
+    m_unverifiedEntries -= it->second.children.size();
+    m_unverified.erase(it);
+}
+
+} // namespace client
+} // namespace one
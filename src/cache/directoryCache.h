@@ -0,0 +1,178 @@
+/**
+ * @file directoryCache.h
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#ifndef ONECLIENT_DIRECTORY_CACHE_H
+#define ONECLIENT_DIRECTORY_CACHE_H
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace one {
+namespace client {
+
+/**
+ * @c DirectoryCache holds complete listings of recently read directories,
+ * keyed by directory uuid. Listings are patched by local modifications of
+ * the directories and dropped when they may have been changed remotely.
+ * The total number of cached children is bounded; least recently used
+ * listings are evicted first.
+ * Listings of directories that are no longer subscribed for changes, or that
+ * have been loaded from a cache file saved by a previous mount, are kept
+ * aside as unverified. An unverified listing is served again only after
+ * the current modification time of its directory has been found equal to
+ * the one recorded with the listing.
+ */
+class DirectoryCache {
+public:
+    /**
+     * Uuids and names of children of a directory.
+     */
+    using Children = std::vector<std::tuple<std::string, std::string>>;
+
+    using Clock = std::chrono::system_clock;
+
+    /**
+     * Constructor.
+     * @param maxEntries Maximal total number of cached children.
+     */
+    DirectoryCache(const std::size_t maxEntries);
+
+    DirectoryCache(DirectoryCache &&) = delete;
+
+    /**
+     * Retrieves a cached listing of a directory.
+     * @param dirUuid Uuid of the directory.
+     * @return Children of the directory if the listing is cached.
+     */
+    boost::optional<Children> get(const std::string &dirUuid);
+
+    /**
+     * Caches a complete listing of a directory.
+     * @param dirUuid Uuid of the directory.
+     * @param children Children of the directory.
+     * @param mtime Modification time of the directory observed before it has
+     * been listed; the listing can be revalidated later only if it is given.
+     */
+    void put(const std::string &dirUuid, Children children,
+        Clock::time_point mtime = {});
+
+    /**
+     * Adds a child to a cached listing, replacing the child of the same name.
+     * Does nothing if the listing is not cached.
+     * @param dirUuid Uuid of the directory.
+     * @param uuid Uuid of the child.
+     * @param name Name of the child.
+     */
+    void addChild(
+        const std::string &dirUuid, std::string uuid, std::string name);
+
+    /**
+     * Removes a child from a cached listing.
+     * Does nothing if the listing is not cached.
+     * @param dirUuid Uuid of the directory.
+     * @param name Name of the child.
+     */
+    void removeChild(const std::string &dirUuid, const std::string &name);
+
+    /**
+     * Drops a cached listing of a directory.
+     * @param dirUuid Uuid of the directory.
+     */
+    void invalidate(const std::string &dirUuid);
+
+    /**
+     * Moves a cached listing of a directory aside as unverified, e.g. when
+     * the directory is no longer subscribed for changes.
+     * @param dirUuid Uuid of the directory.
+     */
+    void retire(const std::string &dirUuid);
+
+    /**
+     * Caches an unverified listing of a directory again if the directory
+     * has not been modified since it was listed. The unverified listing is
+     * dropped either way.
+     * @param dirUuid Uuid of the directory.
+     * @param mtime Current modification time of the directory.
+     * @return true if the listing has been cached.
+     */
+    bool revalidate(const std::string &dirUuid, Clock::time_point mtime);
+
+    /**
+     * Atomically replaces a cache file with revalidable listings. Does
+     * nothing if no listing has changed since the last successful save.
+     * Saves must not run concurrently with each other.
+     * @param file Path of the cache file.
+     * @return true if the file has been written.
+     * @throws std::system_error if the file could not be written.
+     */
+    bool save(const boost::filesystem::path &file);
+
+    /**
+     * Loads listings saved by @c save as unverified. A missing, truncated or
+     * corrupted file is ignored.
+     * @param file Path of the cache file.
+     * @return Number of loaded listings.
+     * @throws std::system_error if the file exists but could not be read.
+     */
+    std::size_t load(const boost::filesystem::path &file);
+
+    /**
+     * @return Total number of cached children.
+     */
+    std::size_t size() const;
+
+    /**
+     * @return Total number of children in unverified listings.
+     */
+    std::size_t unverifiedSize() const;
+
+private:
+    struct Listing {
+        Children children;
+        std::unordered_map<std::string, std::size_t> positions;
+        std::list<std::string>::iterator lruPosition;
+        Clock::time_point mtime;
+    };
+
+    struct UnverifiedListing {
+        Children children;
+        Clock::time_point mtime;
+    };
+
+    std::list<std::string>::iterator erase(
+        std::unordered_map<std::string, Listing>::iterator it);
+    void evict(const std::size_t required, const std::string &keptUuid);
+    void putUnverified(const std::string &dirUuid, UnverifiedListing listing);
+    void eraseUnverified(const std::string &dirUuid);
+
+    const std::size_t m_maxEntries;
+
+    mutable std::mutex m_mutex;
+    std::size_t m_entries = 0;
+    std::list<std::string> m_lru;
+    std::unordered_map<std::string, Listing> m_listings;
+    std::size_t m_unverifiedEntries = 0;
+    std::unordered_map<std::string, UnverifiedListing> m_unverified;
+    std::uint64_t m_version = 0;
+    std::uint64_t m_savedVersion = 0;
+};
+
+} // namespace client
+} // namespace one
+
+#endif // ONECLIENT_DIRECTORY_CACHE_H
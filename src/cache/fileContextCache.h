@@ -10,6 +10,8 @@
 #define ONECLIENT_FILE_CONTEXT_CACHE_H
 
 #include "helpers/IStorageHelper.h"
+#include "syncAhead.h"
+#include "writeAccumulator.h"
 
 #include <boost/optional.hpp>
 #include <fuse/fuse_common.h>
@@ -44,6 +46,13 @@ public:
         std::shared_ptr<boost::optional<std::string>> handleId;
         /// {storageId, fileId} => IStorageHelperCTX
         std::shared_ptr<HelperCtxMap> helperCtxMap;
+        /// Not set if sync-ahead is disabled
+        std::shared_ptr<SyncAhead> syncAhead;
+        /// Blocks written through the handle, not yet in the metadata cache;
+        /// not set if the handle is read-only
+        std::shared_ptr<WriteAccumulator> writeAccumulator;
+        /// Number of write accumulators of the file with pending blocks
+        std::shared_ptr<std::atomic<std::size_t>> pendingWrites;
     };
 
 private:
@@ -0,0 +1,145 @@
+/**
+ * @file inodeCache.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "inodeCache.h"
+
+#include <algorithm>
+#include <mutex>
+#include <system_error>
+
+namespace one {
+namespace client {
+
+InodeCache::InodeCache()
+    : m_nextInode{FUSE_ROOT_ID + 1}
+{
+}
+
+bool InodeCache::hasRoot() const
+{
+    std::shared_lock<std::shared_timed_mutex> lock{m_mutex};
+    return m_inodes.count(FUSE_ROOT_ID) > 0;
+}
+
+void InodeCache::setRoot(const std::string &uuid)
+{
+    std::lock_guard<std::shared_timed_mutex> guard{m_mutex};
+
+    auto &inodes = m_uuidToInodes[uuid];
+    if (std::find(inodes.begin(), inodes.end(), FUSE_ROOT_ID) == inodes.end())
+        inodes.insert(inodes.begin(), FUSE_ROOT_ID);
+
+    auto &entry = m_inodes[FUSE_ROOT_ID];
+    entry.uuid = uuid;
+    entry.nlookup = 1;
+}
+
+std::string InodeCache::uuid(const Inode inode) const
+{
+    std::shared_lock<std::shared_timed_mutex> lock{m_mutex};
+
+    auto it = m_inodes.find(inode);
+    if (it == m_inodes.end())
+        throw std::errc::no_such_file_or_directory;
+
+    return it->second.uuid;
+}
+
+boost::optional<InodeCache::Inode> InodeCache::inode(
+    const std::string &uuid) const
+{
+    std::shared_lock<std::shared_timed_mutex> lock{m_mutex};
+
+    auto it = m_uuidToInodes.find(uuid);
+    if (it == m_uuidToInodes.end())
+        return {};
+
+    return it->second.front();
+}
+
+std::vector<InodeCache::Inode> InodeCache::inodes(
+    const std::string &uuid) const
+{
+    std::shared_lock<std::shared_timed_mutex> lock{m_mutex};
+
+    auto it = m_uuidToInodes.find(uuid);
+    if (it == m_uuidToInodes.end())
+        return {};
+
+    return it->second;
+}
+
+std::pair<InodeCache::Inode, bool> InodeCache::lookup(const std::string &uuid)
+{
+    std::lock_guard<std::shared_timed_mutex> guard{m_mutex};
+
+    auto &inodes = m_uuidToInodes[uuid];
+    const bool created = inodes.empty();
+    if (created) {
+        inodes.emplace_back(m_nextInode++);
+        m_inodes[inodes.front()].uuid = uuid;
+    }
+
+    ++m_inodes[inodes.front()].nlookup;
+    return {inodes.front(), created};
+}
+
+boost::optional<std::string> InodeCache::forget(
+    const Inode inode, const std::uint64_t nlookup)
+{
+    if (inode == FUSE_ROOT_ID)
+        return {};
+
+    std::lock_guard<std::shared_timed_mutex> guard{m_mutex};
+
+    auto it = m_inodes.find(inode);
+    if (it == m_inodes.end())
+        return {};
+
+    auto &entry = it->second;
+    entry.nlookup -= std::min(nlookup, entry.nlookup);
+    if (entry.nlookup > 0)
+        return {};
+
+    auto uuid = std::move(entry.uuid);
+    m_inodes.erase(it);
+
+    auto uuidIt = m_uuidToInodes.find(uuid);
+    if (uuidIt != m_uuidToInodes.end()) {
+        auto &inodes = uuidIt->second;
+        inodes.erase(std::remove(inodes.begin(), inodes.end(), inode),
+            inodes.end());
+        if (inodes.empty())
+            m_uuidToInodes.erase(uuidIt);
+    }
+
+    return uuid;
+}
+
+void InodeCache::rename(const std::string &oldUuid, const std::string &newUuid)
+{
+    std::lock_guard<std::shared_timed_mutex> guard{m_mutex};
+
+    auto it = m_uuidToInodes.find(oldUuid);
+    if (it == m_uuidToInodes.end() || oldUuid == newUuid)
+        return;
+
+    auto renamed = std::move(it->second);
+    m_uuidToInodes.erase(it);
+
+    for (auto inode : renamed)
+        m_inodes[inode].uuid = newUuid;
+
+    // Inodes already assigned to the new uuid stay first, so that lookups
+    // keep returning the same inode
+    auto &inodes = m_uuidToInodes[newUuid];
+    inodes.insert(inodes.end(), renamed.begin(), renamed.end());
+}
+
+} // namespace client
+} // namespace one
@@ -0,0 +1,124 @@
+/**
+ * @file inodeCache.h
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#ifndef ONECLIENT_INODE_CACHE_H
+#define ONECLIENT_INODE_CACHE_H
+
+#include <boost/optional.hpp>
+#include <fuse/fuse_lowlevel.h>
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace one {
+namespace client {
+
+/**
+ * @c InodeCache assigns FUSE inode numbers to file uuids and keeps track of
+ * the kernel's lookup count of each inode. An inode is released when the
+ * kernel forgets all of its lookups. Root directory is always assigned
+ * @c FUSE_ROOT_ID and is never released.
+ * A uuid is assigned more than one inode only if a file is renamed to the
+ * uuid of a file already known to the kernel; new lookups then return the
+ * first inode assigned.
+ */
+class InodeCache {
+public:
+    using Inode = fuse_ino_t;
+
+    /**
+     * Constructor.
+     */
+    InodeCache();
+
+    InodeCache(InodeCache &&) = delete;
+
+    /**
+     * Checks whether the root inode has been mapped to a uuid.
+     * @return true if the root uuid is known.
+     */
+    bool hasRoot() const;
+
+    /**
+     * Maps @c FUSE_ROOT_ID to the uuid of the root directory.
+     * @param uuid Uuid of the root directory.
+     */
+    void setRoot(const std::string &uuid);
+
+    /**
+     * Retrieves uuid of a file assigned to a given inode.
+     * @param inode The inode number.
+     * @return Uuid of the file.
+     * @throws std::errc::no_such_file_or_directory if the inode is not known.
+     */
+    std::string uuid(const Inode inode) const;
+
+    /**
+     * Retrieves inode of a file with a given uuid, if one has been assigned.
+     * The kernel's lookup count is not changed.
+     * @param uuid Uuid of the file.
+     * @return Inode number of the file.
+     */
+    boost::optional<Inode> inode(const std::string &uuid) const;
+
+    /**
+     * Retrieves all inodes assigned to a file with a given uuid.
+     * The kernel's lookup count is not changed.
+     * @param uuid Uuid of the file.
+     * @return Inode numbers of the file.
+     */
+    std::vector<Inode> inodes(const std::string &uuid) const;
+
+    /**
+     * Assigns an inode to a file (if not already assigned) and increments its
+     * lookup count.
+     * @param uuid Uuid of the file.
+     * @return Pair: inode number, true if the inode has been newly assigned.
+     */
+    std::pair<Inode, bool> lookup(const std::string &uuid);
+
+    /**
+     * Decrements the lookup count of an inode, releasing it once the count
+     * drops to zero.
+     * @param inode The inode number.
+     * @param nlookup Number of lookups to forget.
+     * @return Uuid of the file if the inode has been released.
+     */
+    boost::optional<std::string> forget(
+        const Inode inode, const std::uint64_t nlookup);
+
+    /**
+     * Reassigns an inode from one uuid to another, e.g. after the file's
+     * uuid has been changed by a rename.
+     * @param oldUuid Old uuid of the file.
+     * @param newUuid New uuid of the file.
+     */
+    void rename(const std::string &oldUuid, const std::string &newUuid);
+
+private:
+    struct InodeEntry {
+        std::string uuid;
+        std::uint64_t nlookup = 0;
+    };
+
+    // Both maps are guarded by a single mutex, so that a lookup cannot
+    // interleave with the release or reassignment of an inode
+    mutable std::shared_timed_mutex m_mutex;
+    std::unordered_map<std::string, std::vector<Inode>> m_uuidToInodes;
+    std::unordered_map<Inode, InodeEntry> m_inodes;
+    Inode m_nextInode;
+};
+
+} // namespace client
+} // namespace one
+
+#endif // ONECLIENT_INODE_CACHE_H
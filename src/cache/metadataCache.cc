@@ -7,7 +7,7 @@
  */
 
 #include "metadataCache.h"
-#include "fuseOperations.h"
+#include "helpers/interruptibleWait.h"
 
 #include "logging.h"
 #include "messages/fuse/fileRenamed.h"
@@ -15,58 +15,157 @@
 #include "messages/fuse/rename.h"
 #include "scheduler.h"
 
+#include <algorithm>
 #include <chrono>
+#include <climits>
 
 using namespace std::literals;
 
 namespace one {
 namespace client {
 
-MetadataCache::MetadataCache(communication::Communicator &communicator)
+MetadataCache::MetadataCache(communication::Communicator &communicator,
+    const std::size_t missingPathsLimit)
     : m_communicator{communicator}
+    , m_missingPathsLimit{missingPathsLimit}
 {
 }
 
 MetadataCache::FileAttr MetadataCache::getAttr(const Path &path)
 {
-    ConstUuidAccessor constUuidAcc;
-    if (m_pathToUuid.find(constUuidAcc, path))
-        return getAttr(constUuidAcc->second);
+    if (auto uuid = getUuid(path))
+        return getAttr(uuid.get());
 
+    auto attr = resolveAttr(path);
+    auto dentry = toDentry(path);
+
+    // By convention, to avoid deadlocks, always lock on path before metadata
     UuidAccessor uuidAcc;
+    if (!insertDentry(uuidAcc, dentry) && !uuidAcc->second.empty() &&
+        uuidAcc->second != attr.uuid()) {
+        // The path has been mapped to another file while we were resolving it
+        const auto uuid = uuidAcc->second;
+        uuidAcc.release();
+        return getAttr(uuid);
+    }
+
     MetaAccessor metaAcc;
-    getAttr(uuidAcc, metaAcc, path);
+    insertMeta(metaAcc, attr.uuid());
+    uuidAcc->second = attr.uuid();
+    if (!metaAcc->second.attr) {
+        // Do not update cached attrs to avoid race conditions with our own
+        // write events
+        metaAcc.attr(std::move(attr));
+    }
+    metaAcc->second.dentry = std::move(dentry);
     return metaAcc->second.attr.get();
 }
 
 MetadataCache::FileAttr MetadataCache::getAttr(const std::string &uuid)
 {
-    ConstMetaAccessor constAcc;
-    if (m_metaCache.find(constAcc, uuid)) {
-        if (constAcc->second.attr)
-            return constAcc->second.attr.get();
-
-        constAcc.release();
-    }
+    if (auto snapshot = getAttrSnapshot(uuid))
+        return *snapshot;
 
     MetaAccessor acc;
     getAttr(acc, uuid);
     return acc->second.attr.get();
 }
 
+MetadataCache::Path MetadataCache::getPath(const std::string &uuid)
+{
+    auto path = findPath(uuid);
+    if (!path)
+        throw std::errc::no_such_file_or_directory;
+
+    return path.get();
+}
+
+boost::optional<MetadataCache::Path> MetadataCache::findPath(
+    const std::string &uuid)
+{
+    // Bounds the walk in case of a cycle left by concurrent remote renames
+    constexpr std::size_t maxDepth = PATH_MAX / 2;
+
+    std::vector<std::string> names;
+    auto currentUuid = uuid;
+    while (names.size() < maxDepth) {
+        boost::optional<Dentry> dentry;
+        readMeta(currentUuid,
+            [&](const Metadata &metadata) { dentry = metadata.dentry; });
+
+        if (!dentry)
+            return {};
+
+        names.emplace_back(std::move(dentry->name));
+        if (dentry->parentUuid.empty()) {
+            Path path;
+            for (auto it = names.rbegin(); it != names.rend(); ++it)
+                path /= *it;
+
+            return path;
+        }
+
+        currentUuid = std::move(dentry->parentUuid);
+    }
+
+    return {};
+}
+
+boost::optional<std::string> MetadataCache::getUuid(const Path &path)
+{
+    std::string uuid;
+    Path prefix;
+    for (const auto &name : path) {
+        prefix /= name;
+
+        ConstUuidAccessor constAcc;
+        if (uuid.empty() ||
+            !m_dentries.find(constAcc, Dentry{uuid, name.string()})) {
+            if (!m_dentries.find(constAcc, Dentry{"", prefix.string()})) {
+                uuid.clear();
+                continue;
+            }
+        }
+
+        uuid = constAcc->second;
+    }
+
+    if (uuid.empty())
+        return {};
+
+    return uuid;
+}
+
+bool MetadataCache::hasAttr(const std::string &uuid)
+{
+    return getAttrSnapshot(uuid) != nullptr;
+}
+
+bool MetadataCache::putAttr(FileAttr attr)
+{
+    MetaAccessor acc;
+    insertMeta(acc, attr.uuid());
+    if (acc->second.attr)
+        return false;
+
+    acc.attr(std::move(attr));
+    return true;
+}
+
 MetadataCache::FileLocation MetadataCache::getLocation(
     const std::string &uuid, const one::helpers::FlagsSet flags)
 {
     auto filteredFlags = filterFlagsForLocation(flags);
 
-    ConstMetaAccessor constAcc;
-    if (m_metaCache.find(constAcc, uuid)) {
-        if (constAcc->second.locations.find(filteredFlags) !=
-            constAcc->second.locations.end())
-            return constAcc->second.locations.at(filteredFlags);
+    boost::optional<FileLocation> location;
+    readMeta(uuid, [&](const Metadata &metadata) {
+        auto it = metadata.locations.find(filteredFlags);
+        if (it != metadata.locations.end())
+            location = it->second;
+    });
 
-        constAcc.release();
-    }
+    if (location)
+        return std::move(location.get());
 
     MetaAccessor acc;
     getLocation(acc, uuid, flags);
@@ -82,53 +181,58 @@ void MetadataCache::getAttr(MetaAccessor &metaAcc, const Path &path)
 void MetadataCache::getAttr(
     UuidAccessor &uuidAcc, MetaAccessor &metaAcc, const Path &path)
 {
-    if (!m_pathToUuid.insert(uuidAcc, path)) {
+    // Fetch missing metadata before taking the accessors, so that the
+    // remote call does not block other users of the entries; the fetch
+    // below is only needed if the entries are removed in the meantime
+    getAttr(path);
+    auto dentry = toDentry(path);
+
+    if (!insertDentry(uuidAcc, dentry)) {
         getAttr(metaAcc, uuidAcc->second);
-        metaAcc->second.path = path;
+        metaAcc->second.dentry = std::move(dentry);
         return;
     }
 
     try {
-        DLOG(INFO) << "Fetching attributes for " << path;
-        auto attr = fetchAttr(messages::fuse::ResolveGuid{path});
+        auto attr = resolveAttr(path);
+
         uuidAcc->second = attr.uuid();
-        if (m_metaCache.insert(metaAcc, attr.uuid())) {
+        if (insertMeta(metaAcc, attr.uuid())) {
             // In this case we're fetching attributes because we didn't know
             // the path mapped to an already cached uuid. Do not update attrs
             // to avoid race conditions with our own write events.
-            metaAcc->second.attr = std::move(attr);
+            metaAcc.attr(std::move(attr));
         }
-        metaAcc->second.path = path;
+        metaAcc->second.dentry = std::move(dentry);
     }
     catch (...) {
         if (!metaAcc.empty())
-            m_metaCache.erase(metaAcc);
+            eraseMeta(metaAcc);
 
-        m_pathToUuid.erase(uuidAcc);
+        eraseDentry(uuidAcc);
         throw;
     }
 }
 
 bool MetadataCache::get(MetaAccessor &metaAcc, const std::string &uuid)
 {
-    return m_metaCache.find(metaAcc, uuid);
+    return findMeta(metaAcc, uuid);
 }
 
 void MetadataCache::getAttr(MetaAccessor &metaAcc, const std::string &uuid)
 {
-    if (!m_metaCache.insert(metaAcc, uuid)) {
+    if (findMeta(metaAcc, uuid)) {
         if (metaAcc->second.attr)
             return;
-    }
 
-    try {
-        DLOG(INFO) << "Fetching attributes for " << uuid;
-        metaAcc->second.attr = fetchAttr(messages::fuse::GetFileAttr{uuid});
-    }
-    catch (...) {
-        m_metaCache.erase(metaAcc);
-        throw;
+        metaAcc.release();
     }
+
+    auto attr = fetchAttr(uuid);
+
+    insertMeta(metaAcc, uuid);
+    if (!metaAcc->second.attr)
+        metaAcc.attr(std::move(attr));
 }
 
 void MetadataCache::getLocation(MetadataCache::MetaAccessor &metaAcc,
@@ -136,48 +240,55 @@ void MetadataCache::getLocation(MetadataCache::MetaAccessor &metaAcc,
 {
     auto filteredFlags = filterFlagsForLocation(flags);
 
-    if (!m_metaCache.insert(metaAcc, uuid)) {
+    if (findMeta(metaAcc, uuid)) {
         if (metaAcc->second.locations.find(filteredFlags) !=
             metaAcc->second.locations.end())
             return;
+
+        metaAcc.release();
     }
 
-    try {
-        DLOG(INFO) << "Fetching file location for " << uuid;
-        auto future = m_communicator.communicate<FileLocation>(
-            messages::fuse::GetFileLocation{uuid, flags});
+    auto location = fetchLocation(uuid, flags);
 
-        metaAcc->second.locations[filteredFlags] = communication::wait(future);
-    }
-    catch (...) {
-        m_metaCache.erase(metaAcc);
-        throw;
-    }
+    // A location updated while fetching is newer than the fetched one
+    insertMeta(metaAcc, uuid);
+    metaAcc->second.locations.emplace(filteredFlags, std::move(location));
 }
 
 std::vector<std::pair<std::string, std::string>> MetadataCache::rename(
     const MetadataCache::Path &oldPath, const MetadataCache::Path &newPath)
 {
+    forgetMissing(newPath);
+
+    // Resolving the old path walks through the dentries of its ancestors, so
+    // it must not be a descendant of the locked new path
+    if (std::mismatch(newPath.begin(), newPath.end(), oldPath.begin(),
+            oldPath.end())
+            .first == newPath.end())
+        throw std::errc::invalid_argument;
+
+    auto newDentry = toDentry(newPath);
+
     // By convention, to avoid deadlocks, always lock on path before metadata
     UuidAccessor newUuidAcc;
-    m_pathToUuid.insert(newUuidAcc, newPath);
+    insertDentry(newUuidAcc, newDentry);
     std::vector<std::pair<std::string, std::string>> uuidChanges;
 
     try {
         UuidAccessor oldUuidAcc;
         MetaAccessor oldMetaAcc;
         getAttr(oldUuidAcc, oldMetaAcc, oldPath);
-        auto &oldUuid = oldMetaAcc->second.attr.get().uuid();
+        const auto oldUuid = oldMetaAcc->second.attr.get().uuid();
 
         DLOG(INFO) << "Renaming file " << oldUuid << " to " << newPath;
 
-        m_pathToUuid.erase(oldUuidAcc);
+        eraseDentry(oldUuidAcc);
 
         if (oldMetaAcc->second.state == FileState::removedUpstream) {
             // This rename operation was executed by fileRemovalHandler
             // Only oldPath is changed to newPath
             oldMetaAcc->second.locations.clear();
-            oldMetaAcc->second.path = newPath;
+            oldMetaAcc->second.dentry = newUuidAcc->first;
             newUuidAcc->second = oldUuid;
         }
         else if (oldMetaAcc->second.state == FileState::renamedUpstream) {
@@ -200,7 +311,7 @@ std::vector<std::pair<std::string, std::string>> MetadataCache::rename(
             if (newUuidAcc->second != "") {
                 MetaAccessor targetMetaAcc;
                 if (get(targetMetaAcc, newUuidAcc->second)) {
-                    m_metaCache.erase(targetMetaAcc);
+                    eraseMeta(targetMetaAcc);
                 }
             }
 
@@ -219,7 +330,9 @@ std::vector<std::pair<std::string, std::string>> MetadataCache::rename(
         }
     }
     catch (...) {
-        m_pathToUuid.erase(newUuidAcc);
+        if (!newUuidAcc.empty())
+            eraseDentry(newUuidAcc);
+
         throw;
     }
 
@@ -230,24 +343,35 @@ void MetadataCache::remapFile(MetaAccessor &oldMetaAcc,
     UuidAccessor &newUuidAcc, const std::string &oldUuid,
     const std::string &newUuid, const Path &newPath)
 {
+    DLOG(INFO) << "Remapping file " << oldUuid << " to " << newUuid << " at "
+               << newPath;
+
     newUuidAcc->second = newUuid;
+    auto newDentry = newUuidAcc->first;
     newUuidAcc.release();
 
-    m_pathToUuid.erase(oldMetaAcc->second.path.get());
+    // Children of a renamed directory keep their dentries if the uuid of the
+    // directory has not changed
+    const auto &oldDentry = oldMetaAcc->second.dentry;
+    if (oldDentry && !DentryHash::equal(oldDentry.get(), newDentry))
+        eraseDentry(oldDentry.get());
+
     if (newUuid != oldUuid) {
         // Copy and update old metadata if uuid has changed
         auto attr = oldMetaAcc->second.attr;
-        m_metaCache.erase(oldMetaAcc);
+        eraseMeta(oldMetaAcc);
 
         MetaAccessor newMetaAcc;
-        m_metaCache.insert(newMetaAcc, newUuid);
-        newMetaAcc->second.attr = attr;
-        newMetaAcc->second.attr->uuid(newUuid);
-        newMetaAcc->second.path = newPath;
+        insertMeta(newMetaAcc, newUuid);
+        if (attr) {
+            newMetaAcc.attr(std::move(attr.get()));
+            newMetaAcc.attr().uuid(newUuid);
+        }
+        newMetaAcc->second.dentry = std::move(newDentry);
     }
     else {
         // Update metadata if uuid has not changed
-        oldMetaAcc->second.path = newPath;
+        oldMetaAcc->second.dentry = std::move(newDentry);
         oldMetaAcc->second.locations.clear();
         oldMetaAcc.release();
     }
@@ -256,68 +380,259 @@ void MetadataCache::remapFile(MetaAccessor &oldMetaAcc,
 void MetadataCache::remapFile(
     const std::string &oldUuid, const std::string &newUuid, const Path &newPath)
 {
+    forgetMissing(newPath);
+
     UuidAccessor newUuidAcc;
-    m_pathToUuid.insert(newUuidAcc, newPath);
+    insertDentry(newUuidAcc, toDentry(newPath));
+
     MetaAccessor oldMetaAcc;
     if (get(oldMetaAcc, oldUuid))
         remapFile(oldMetaAcc, newUuidAcc, oldUuid, newUuid, newPath);
+    else if (newUuidAcc->second.empty())
+        eraseDentry(newUuidAcc);
 }
 
 void MetadataCache::map(Path path, std::string uuid)
 {
+    forgetMissing(path);
+    auto dentry = toDentry(path);
+
     UuidAccessor uuidAcc;
-    m_pathToUuid.insert(uuidAcc, path);
+    insertDentry(uuidAcc, dentry);
 
     MetaAccessor metaAcc;
-    m_metaCache.insert(metaAcc, uuid);
+    insertMeta(metaAcc, uuid);
 
     uuidAcc->second = std::move(uuid);
-    metaAcc->second.path = std::move(path);
+    metaAcc->second.dentry = std::move(dentry);
 }
 
 void MetadataCache::map(
     Path path, FileLocation location, const one::helpers::FlagsSet flags)
 {
     auto filteredFlags = filterFlagsForLocation(flags);
+    forgetMissing(path);
+    auto dentry = toDentry(path);
 
     UuidAccessor uuidAcc;
-    m_pathToUuid.insert(uuidAcc, path);
+    insertDentry(uuidAcc, dentry);
 
     MetaAccessor metaAcc;
-    m_metaCache.insert(metaAcc, location.uuid());
+    insertMeta(metaAcc, location.uuid());
 
     uuidAcc->second = location.uuid();
-    metaAcc->second.path = std::move(path);
+    metaAcc->second.dentry = std::move(dentry);
     metaAcc->second.locations[filteredFlags] = std::move(location);
 }
 
 void MetadataCache::remove(UuidAccessor &uuidAcc, MetaAccessor &metaAcc)
 {
-    m_metaCache.erase(metaAcc);
-    m_pathToUuid.erase(uuidAcc);
+    eraseMeta(metaAcc);
+    eraseDentry(uuidAcc);
 }
 
 void MetadataCache::removePathMapping(
     UuidAccessor &uuidAcc, MetaAccessor &metaAcc)
 {
-    m_pathToUuid.erase(uuidAcc);
+    eraseDentry(uuidAcc);
+    metaAcc->second.dentry = boost::none;
 }
 
 void MetadataCache::remove(const std::string &uuid)
 {
     MetaAccessor metaAcc;
-    if (!m_metaCache.find(metaAcc, uuid))
+    if (!findMeta(metaAcc, uuid))
         return;
 
-    if (metaAcc->second.path) {
+    if (metaAcc->second.dentry) {
         UuidAccessor uuidAcc;
-        if (m_pathToUuid.find(uuidAcc, metaAcc->second.path.get())) {
+        if (m_dentries.find(uuidAcc, metaAcc->second.dentry.get()) &&
+            uuidAcc->second == uuid) {
             remove(uuidAcc, metaAcc);
             return;
         }
     }
 
-    m_metaCache.erase(metaAcc);
+    eraseMeta(metaAcc);
+}
+
+MetadataCache::FileAttr &MetadataCache::MetaAccessor::attr()
+{
+    m_attrChanged = true;
+    return m_record->value.second.attr.get();
+}
+
+void MetadataCache::MetaAccessor::attr(FileAttr attr)
+{
+    m_attrChanged = true;
+    m_record->value.second.attr = std::move(attr);
+}
+
+void MetadataCache::MetaAccessor::publish()
+{
+    if (!m_attrChanged || empty())
+        return;
+
+    auto &metadata = m_record->value.second;
+    std::shared_ptr<const FileAttr> snapshot;
+    if (metadata.attr)
+        snapshot = std::make_shared<const FileAttr>(metadata.attr.get());
+
+    std::atomic_store(&metadata.publishedAttr, std::move(snapshot));
+    m_attrChanged = false;
+}
+
+MetadataCache::MetaAccessor::~MetaAccessor()
+{
+    try {
+        publish();
+    }
+    catch (...) {
+        // Readers must not see attributes older than the cached ones
+        std::atomic_store(&m_record->value.second.publishedAttr,
+            std::shared_ptr<const FileAttr>{});
+    }
+}
+
+void MetadataCache::MetaAccessor::release()
+{
+    publish();
+    m_lock = {};
+    m_record.reset();
+}
+
+std::shared_ptr<const MetadataCache::FileAttr> MetadataCache::getAttrSnapshot(
+    const std::string &uuid)
+{
+    auto record = findRecord(uuid);
+    if (!record)
+        return {};
+
+    return std::atomic_load(&record->value.second.publishedAttr);
+}
+
+std::shared_ptr<MetadataCache::Record> MetadataCache::findRecord(
+    const std::string &uuid)
+{
+    ConstRecordAccessor constAcc;
+    if (!m_metaCache.find(constAcc, uuid))
+        return {};
+
+    return constAcc->second;
+}
+
+bool MetadataCache::lockRecord(
+    MetaAccessor &metaAcc, std::shared_ptr<Record> record)
+{
+    std::unique_lock<std::shared_timed_mutex> lock{record->mutex};
+    if (record->erased)
+        return false;
+
+    metaAcc.m_record = std::move(record);
+    metaAcc.m_lock = std::move(lock);
+    return true;
+}
+
+template <typename Read>
+bool MetadataCache::readMeta(const std::string &uuid, Read &&read)
+{
+    while (auto record = findRecord(uuid)) {
+        std::shared_lock<std::shared_timed_mutex> lock{record->mutex};
+        if (!record->erased) {
+            read(static_cast<const Metadata &>(record->value.second));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool MetadataCache::findMeta(MetaAccessor &metaAcc, const std::string &uuid)
+{
+    metaAcc.release();
+
+    // A record erased while waiting for its lock has been replaced or
+    // removed from the cache, so it is looked up again
+    while (auto record = findRecord(uuid)) {
+        if (lockRecord(metaAcc, std::move(record)))
+            return true;
+    }
+
+    return false;
+}
+
+bool MetadataCache::insertMeta(MetaAccessor &metaAcc, const std::string &uuid)
+{
+    metaAcc.release();
+
+    while (true) {
+        RecordAccessor acc;
+        if (m_metaCache.insert(acc, uuid)) {
+            // Nobody else can wait for the lock of a new record, so it is
+            // taken while the record is still locked in the cache
+            try {
+                acc->second = std::make_shared<Record>(uuid);
+            }
+            catch (...) {
+                m_metaCache.erase(acc);
+                throw;
+            }
+
+            lockRecord(metaAcc, acc->second);
+            return true;
+        }
+
+        auto record = acc->second;
+        acc.release();
+        if (lockRecord(metaAcc, std::move(record)))
+            return false;
+    }
+}
+
+void MetadataCache::eraseMeta(MetaAccessor &metaAcc)
+{
+    auto &record = metaAcc.m_record;
+    record->erased = true;
+    std::atomic_store(&record->value.second.publishedAttr,
+        std::shared_ptr<const FileAttr>{});
+
+    RecordAccessor acc;
+    if (m_metaCache.find(acc, record->value.first) && acc->second == record)
+        m_metaCache.erase(acc);
+
+    acc.release();
+    metaAcc.m_attrChanged = false;
+    metaAcc.release();
+}
+
+bool MetadataCache::insertDentry(UuidAccessor &uuidAcc, const Dentry &dentry)
+{
+    if (!m_dentries.insert(uuidAcc, dentry))
+        return false;
+
+    m_dentriesSize += dentrySize(dentry);
+    return true;
+}
+
+void MetadataCache::eraseDentry(UuidAccessor &uuidAcc)
+{
+    m_dentriesSize -= dentrySize(uuidAcc->first);
+    m_dentries.erase(uuidAcc);
+}
+
+void MetadataCache::eraseDentry(const Dentry &dentry)
+{
+    UuidAccessor uuidAcc;
+    if (m_dentries.find(uuidAcc, dentry))
+        eraseDentry(uuidAcc);
+}
+
+std::size_t MetadataCache::dentrySize(const Dentry &dentry)
+{
+    // The mapped uuid is counted as long as the parent uuid, which is exact
+    // for all dentries but those indexed by full paths
+    return sizeof(decltype(m_dentries)::value_type) +
+        2 * dentry.parentUuid.size() + dentry.name.size();
 }
 
 std::size_t MetadataCache::PathHash::hash(const Path &path)
@@ -330,6 +645,33 @@ bool MetadataCache::PathHash::equal(const Path &a, const Path &b)
     return a == b;
 }
 
+std::size_t MetadataCache::DentryHash::hash(const Dentry &dentry)
+{
+    std::size_t seed = 0;
+    boost::hash_combine(seed, dentry.parentUuid);
+    boost::hash_combine(seed, dentry.name);
+    return seed;
+}
+
+bool MetadataCache::DentryHash::equal(const Dentry &a, const Dentry &b)
+{
+    return a.parentUuid == b.parentUuid && a.name == b.name;
+}
+
+std::size_t MetadataCache::LocationKeyHash::hash(const LocationKey &key)
+{
+    std::size_t seed = 0;
+    boost::hash_combine(seed, key.first);
+    boost::hash_combine(seed, static_cast<int>(key.second));
+    return seed;
+}
+
+bool MetadataCache::LocationKeyHash::equal(
+    const LocationKey &a, const LocationKey &b)
+{
+    return a == b;
+}
+
 bool MetadataCache::waitForNewLocation(const std::string &uuid,
     const boost::icl::discrete_interval<off_t> &range,
     const std::chrono::milliseconds &timeout,
@@ -337,57 +679,233 @@ bool MetadataCache::waitForNewLocation(const std::string &uuid,
 {
     LOG(INFO) << "Waiting for file_location of '" << uuid << "' at range "
               << range;
-    auto pair = getMutexConditionPair(uuid);
-    std::unique_lock<std::mutex> lock{pair.first};
 
+    // The location is fetched before waiting, as the predicate runs under
+    // the waiters' mutex and must not block on a remote call
+    getLocation(uuid, flags);
+
+    auto waiters = addLocationWaiter(uuid);
+
+    // The wait is woken up on interruption under the mutex, so that the
+    // notification cannot be lost between checking and waiting
+    helpers::InterruptibleWait wait{timeout, [&] {
+                                        std::lock_guard<std::mutex> guard{
+                                            waiters->mutex};
+                                        waiters->condition.notify_all();
+                                    }};
+
+    std::unique_lock<std::mutex> lock{waiters->mutex};
+
+    // Locations of open files are pinned in the cache, so a missing one is
+    // merely treated as not synchronized yet
+    const auto filteredFlags = filterFlagsForLocation(flags);
     const auto pred = [&] {
-        FileLocation location = getLocation(uuid, flags);
-        return location.blocks().find(boost::icl::first(range)) !=
-            location.blocks().end();
+        bool synchronized = false;
+        readMeta(uuid, [&](const Metadata &metadata) {
+            const auto it = metadata.locations.find(filteredFlags);
+            if (it != metadata.locations.end())
+                synchronized =
+                    it->second.blocks().find(boost::icl::first(range)) !=
+                    it->second.blocks().end();
+        });
+
+        return synchronized;
     };
 
-    for (auto t = 0ms; t < timeout; ++t) {
-        if (helpers::fuseInterrupted())
-            throw std::system_error{
-                std::make_error_code(std::errc::operation_canceled)};
-
-        if (pair.second.wait_for(lock, 1ms, pred))
-            return true;
+    try {
+        auto synchronized =
+            helpers::waitInterruptibly(waiters->condition, lock, wait, pred);
+        lock.unlock();
+        removeLocationWaiter(uuid);
+        return synchronized;
+    }
+    catch (...) {
+        lock.unlock();
+        removeLocationWaiter(uuid);
+        throw;
     }
-
-    return false;
 }
 
 void MetadataCache::notifyNewLocationArrived(const std::string &uuid)
 {
     MutexAccessor acc;
     if (m_mutexConditionPairMap.find(acc, uuid)) {
-        std::condition_variable &condition = *acc->second.second;
-        condition.notify_all();
+        // Lock the mutex so that the notification cannot be lost by a waiter
+        // that has just checked its predicate
+        std::lock_guard<std::mutex> guard{acc->second->mutex};
+        acc->second->condition.notify_all();
     }
 }
 
-std::pair<std::mutex &, std::condition_variable &>
-MetadataCache::getMutexConditionPair(const std::string &uuid)
+std::shared_ptr<MetadataCache::LocationWaiters>
+MetadataCache::addLocationWaiter(const std::string &uuid)
 {
     MutexAccessor acc;
     if (m_mutexConditionPairMap.insert(acc, uuid))
-        acc->second = std::make_pair(std::make_unique<std::mutex>(),
-            std::make_unique<std::condition_variable>());
-    return {*acc->second.first, *acc->second.second};
+        acc->second = std::make_shared<LocationWaiters>();
+
+    ++acc->second->count;
+    return acc->second;
+}
+
+void MetadataCache::removeLocationWaiter(const std::string &uuid)
+{
+    MutexAccessor acc;
+    if (m_mutexConditionPairMap.find(acc, uuid) && --acc->second->count == 0)
+        m_mutexConditionPairMap.erase(acc);
+}
+
+std::size_t MetadataCache::size() const { return m_metaCache.size(); }
+
+std::size_t MetadataCache::footprint() const
+{
+    // Attributes and locations are modified in place through accessors, so
+    // entries are counted by a typical size of a file with one location and
+    // published attributes
+    constexpr std::size_t metaEntrySize =
+        sizeof(decltype(m_metaCache)::value_type) + sizeof(Record) +
+        2 * sizeof(FileAttr) + sizeof(FileLocation) + 512;
+
+    return m_metaCache.size() * metaEntrySize + m_dentriesSize;
+}
+
+void MetadataCache::forgetMissing(const Path &path)
+{
+    if (eraseMissing(path))
+        m_missingPathsExpirationHelper.forget(path.string());
 }
 
-MetadataCache::FileAttr MetadataCache::fetchAttr(
-    messages::ClientMessage &&request)
+void MetadataCache::forgetMissingChildren(const Path &dirPath)
 {
-    auto future = m_communicator.communicate<FileAttr>(std::move(request));
+    std::unordered_set<std::string> names;
+    {
+        std::lock_guard<std::mutex> guard{m_missingPathsMutex};
+
+        auto it = m_missingPaths.find(dirPath.string());
+        if (it == m_missingPaths.end())
+            return;
+
+        m_missingPathsCount -= it->second.size();
+        names.swap(it->second);
+        m_missingPaths.erase(it);
+    }
+
+    for (const auto &name : names)
+        m_missingPathsExpirationHelper.forget((dirPath / name).string());
+}
+
+void MetadataCache::expireMissingPaths()
+{
+    // The helper stops tracking expired paths by itself
+    m_missingPathsExpirationHelper.tick(
+        [this](const std::string &path) { eraseMissing(path); });
+}
+
+bool MetadataCache::eraseMissing(const Path &path)
+{
+    std::lock_guard<std::mutex> guard{m_missingPathsMutex};
+
+    auto it = m_missingPaths.find(path.parent_path().string());
+    if (it == m_missingPaths.end())
+        return false;
+
+    const auto erased = it->second.erase(path.filename().string());
+    m_missingPathsCount -= erased;
+    if (it->second.empty())
+        m_missingPaths.erase(it);
+
+    return erased > 0;
+}
+
+bool MetadataCache::isMissing(const Path &path)
+{
+    // Lookups do not prolong the life of the record, so that files created
+    // remotely become visible within a bounded time
+    std::lock_guard<std::mutex> guard{m_missingPathsMutex};
+
+    auto it = m_missingPaths.find(path.parent_path().string());
+    return it != m_missingPaths.end() &&
+        it->second.count(path.filename().string());
+}
+
+void MetadataCache::markMissing(const Path &path)
+{
+    {
+        std::lock_guard<std::mutex> guard{m_missingPathsMutex};
+
+        if (m_missingPathsCount >= m_missingPathsLimit)
+            return;
+
+        if (!m_missingPaths[path.parent_path().string()]
+                 .emplace(path.filename().string())
+                 .second)
+            return;
+
+        ++m_missingPathsCount;
+    }
+
+    m_missingPathsExpirationHelper.markInteresting(path.string(), [] {});
+}
+
+MetadataCache::Dentry MetadataCache::toDentry(const Path &path)
+{
+    if (path.has_parent_path()) {
+        if (auto parentUuid = getUuid(path.parent_path()))
+            return {std::move(parentUuid.get()), path.filename().string()};
+    }
+
+    return {"", path.string()};
+}
+
+MetadataCache::FileAttr MetadataCache::fetchAttr(const std::string &uuid)
+{
+    auto attr = m_attrFlights.get(uuid, [&] {
+        DLOG(INFO) << "Fetching attributes for " << uuid;
+        return m_communicator.communicate<FileAttr>(
+            messages::fuse::GetFileAttr{uuid});
+    });
 
-    auto attr = communication::wait(future);
     if (!attr.size().is_initialized())
         throw std::errc::protocol_error;
 
     return attr;
 }
 
+MetadataCache::FileAttr MetadataCache::resolveAttr(const Path &path)
+{
+    if (isMissing(path))
+        throw std::errc::no_such_file_or_directory;
+
+    try {
+        auto attr = m_pathFlights.get(path, [&] {
+            DLOG(INFO) << "Fetching attributes for " << path;
+            return m_communicator.communicate<FileAttr>(
+                messages::fuse::ResolveGuid{path});
+        });
+
+        if (!attr.size().is_initialized())
+            throw std::errc::protocol_error;
+
+        return attr;
+    }
+    catch (const std::system_error &e) {
+        if (e.code() == std::errc::no_such_file_or_directory)
+            markMissing(path);
+
+        throw;
+    }
+}
+
+MetadataCache::FileLocation MetadataCache::fetchLocation(
+    const std::string &uuid, const one::helpers::FlagsSet flags)
+{
+    return m_locationFlights.get(
+        std::make_pair(uuid, filterFlagsForLocation(flags)), [&] {
+            DLOG(INFO) << "Fetching file location for " << uuid;
+            return m_communicator.communicate<FileLocation>(
+                messages::fuse::GetFileLocation{uuid, flags});
+        });
+}
+
 } // namespace one
 } // namespace client
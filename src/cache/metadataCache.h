@@ -9,20 +9,28 @@
 #ifndef ONECLIENT_METADATA_CACHE_H
 #define ONECLIENT_METADATA_CACHE_H
 
+#include "cacheExpirationHelper.h"
 #include "communication/communicator.h"
 #include "messages/fuse/fileAttr.h"
 #include "messages/fuse/fileLocation.h"
 #include "messages/clientMessage.h"
 #include "messages/fuse/getFileAttr.h"
 #include "messages/fuse/resolveGuid.h"
+#include "singleFlight.h"
 
 #include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
 #include <boost/functional/hash.hpp>
 #include <tbb/concurrent_hash_map.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <helpers/IStorageHelper.h>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace std {
 template <> struct hash<one::helpers::Flag> {
@@ -39,6 +47,18 @@ namespace client {
 /**
  * @c MetadataCache is responsible for retrieving and caching path<->uuid,
  * uuid<->fileAttrs, and uuid<->fileLocation mappings.
+ * Paths are indexed by dentries - uuids of parent directories and names of
+ * files - and resolved component by component, so that renaming a directory
+ * does not affect the cached entries of its descendants. Files cached before
+ * their parent directories are indexed by their full paths.
+ * Missing data is fetched without holding any accessor, and concurrent
+ * requests for the same data share a single fetch.
+ * Metadata of each file is guarded by its own lock, so the index of files is
+ * locked only to find them. Attributes are additionally published as
+ * immutable snapshots, replaced when a @c MetaAccessor that changed them is
+ * released. Readers of attributes share the snapshots, so they never wait for
+ * holders of a @c MetaAccessor, e.g. for a remote call made under the
+ * accessor.
  */
 class MetadataCache {
 public:
@@ -47,14 +67,27 @@ public:
     using FileLocation = messages::fuse::FileLocation;
     enum FileState { normal, removedUpstream, renamedUpstream };
 
+    /**
+     * @c Dentry identifies a file by the uuid of its parent directory and its
+     * name. A file whose parent directory is not cached, e.g. the root
+     * directory, has an empty parent uuid and its full path as the name.
+     */
+    struct Dentry {
+        std::string parentUuid;
+        std::string name;
+    };
+
     /**
      * @c Metadata holds metadata of a file.
      */
     struct Metadata {
-        boost::optional<Path> path;
+        boost::optional<Dentry> dentry;
         boost::optional<FileAttr> attr;
         std::unordered_map<one::helpers::Flag, FileLocation> locations;
         FileState state = normal;
+        /// Snapshot of @c attr last published to readers. Accessed only with
+        /// @c std::atomic_load and @c std::atomic_store.
+        std::shared_ptr<const FileAttr> publishedAttr;
     };
 
 private:
@@ -63,28 +96,123 @@ private:
         static bool equal(const Path &, const Path &);
     };
 
-    tbb::concurrent_hash_map<Path, std::string, PathHash> m_pathToUuid;
-    tbb::concurrent_hash_map<std::string, Metadata> m_metaCache;
-    tbb::concurrent_hash_map<std::string,
-        std::pair<std::unique_ptr<std::mutex>,
-                                 std::unique_ptr<std::condition_variable>>>
+    struct DentryHash {
+        static std::size_t hash(const Dentry &);
+        static bool equal(const Dentry &, const Dentry &);
+    };
+
+    using LocationKey = std::pair<std::string, one::helpers::Flag>;
+    struct LocationKeyHash {
+        static std::size_t hash(const LocationKey &);
+        static bool equal(const LocationKey &, const LocationKey &);
+    };
+
+    /**
+     * @c LocationWaiters synchronizes threads waiting for a location update
+     * of a file. It exists only as long as anyone waits for the update.
+     */
+    struct LocationWaiters {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::size_t count = 0;
+    };
+
+    /**
+     * @c Record holds metadata of a file and the lock guarding it.
+     */
+    struct Record {
+        explicit Record(std::string uuid)
+            : value{std::move(uuid), Metadata{}}
+        {
+        }
+
+        std::shared_timed_mutex mutex;
+        std::pair<const std::string, Metadata> value;
+        /// Set under the lock when the record is removed from the cache, for
+        /// threads that have found the record before and wait for the lock.
+        bool erased = false;
+    };
+
+    tbb::concurrent_hash_map<Dentry, std::string, DentryHash> m_dentries;
+    tbb::concurrent_hash_map<std::string, std::shared_ptr<Record>> m_metaCache;
+    tbb::concurrent_hash_map<std::string, std::shared_ptr<LocationWaiters>>
         m_mutexConditionPairMap;
 
+    using ConstRecordAccessor = decltype(m_metaCache)::const_accessor;
+    using RecordAccessor = decltype(m_metaCache)::accessor;
+
 public:
-    using ConstUuidAccessor = decltype(m_pathToUuid)::const_accessor;
-    using ConstMetaAccessor = decltype(m_metaCache)::const_accessor;
+    using ConstUuidAccessor = decltype(m_dentries)::const_accessor;
     using ConstMutexAccessor =
         decltype(m_mutexConditionPairMap)::const_accessor;
-    using UuidAccessor = decltype(m_pathToUuid)::accessor;
-    using MetaAccessor = decltype(m_metaCache)::accessor;
+    using UuidAccessor = decltype(m_dentries)::accessor;
     using MutexAccessor = decltype(m_mutexConditionPairMap)::accessor;
 
+    /**
+     * @c MetaAccessor grants exclusive access to metadata of a file.
+     * Attributes changed through @c attr() are published to readers when the
+     * accessor is released.
+     */
+    class MetaAccessor {
+    public:
+        using value_type = std::pair<const std::string, Metadata>;
+
+        MetaAccessor() = default;
+        MetaAccessor(const MetaAccessor &) = delete;
+        MetaAccessor &operator=(const MetaAccessor &) = delete;
+        ~MetaAccessor();
+
+        /**
+         * @return true if the accessor does not grant access to any metadata.
+         */
+        bool empty() const { return !m_record; }
+
+        value_type &operator*() const { return m_record->value; }
+        value_type *operator->() const { return &m_record->value; }
+
+        /**
+         * Grants write access to cached attributes, which are published when
+         * the accessor is released.
+         * @return The cached attributes, which must be set.
+         */
+        FileAttr &attr();
+
+        /**
+         * Sets cached attributes, which are published when the accessor is
+         * released.
+         * @param attr The attributes to cache.
+         */
+        void attr(FileAttr attr);
+
+        /**
+         * Publishes changed attributes and releases the accessor.
+         */
+        void release();
+
+    private:
+        friend class MetadataCache;
+        void publish();
+
+        std::shared_ptr<Record> m_record;
+        std::unique_lock<std::shared_timed_mutex> m_lock;
+        bool m_attrChanged = false;
+    };
+
+    /**
+     * Number of calls to @c expireMissingPaths() after which a path is no
+     * longer known to be missing.
+     */
+    static constexpr std::size_t MISSING_PATHS_TTL = 5;
+
     /**
      * Constructor.
      * @param communicator Communicator instance used for fetching missing
      * data.
+     * @param missingPathsLimit Maximal number of paths remembered to be
+     * missing, 0 disables remembering them.
      */
-    MetadataCache(communication::Communicator &communicator);
+    MetadataCache(communication::Communicator &communicator,
+        const std::size_t missingPathsLimit = 0);
 
     MetadataCache(MetadataCache &&) = delete;
 
@@ -111,6 +239,54 @@ public:
      */
     FileAttr getAttr(const std::string &uuid);
 
+    /**
+     * Retrieves a published snapshot of cached attributes of a file.
+     * Never waits for holders of a @c MetaAccessor.
+     * @param uuid The uuid of the file.
+     * @return The snapshot, or nullptr if attributes are not cached.
+     */
+    std::shared_ptr<const FileAttr> getAttrSnapshot(const std::string &uuid);
+
+    /**
+     * Retrieves the last known path of a file with given uuid, without
+     * consulting the remote endpoint.
+     * @param uuid The uuid of a file to retrieve path of.
+     * @return Path of the file.
+     * @throws std::errc::no_such_file_or_directory if the path is not known.
+     */
+    Path getPath(const std::string &uuid);
+
+    /**
+     * Retrieves the last known path of a file with given uuid, without
+     * consulting the remote endpoint.
+     * @param uuid The uuid of a file to retrieve path of.
+     * @return Path of the file if the file and all its ancestors are cached.
+     */
+    boost::optional<Path> findPath(const std::string &uuid);
+
+    /**
+     * Retrieves the uuid of a file mapped to a given path, without consulting
+     * the remote endpoint.
+     * @param path The path of a file to retrieve uuid of.
+     * @return Uuid of the file if the path is cached.
+     */
+    boost::optional<std::string> getUuid(const Path &path);
+
+    /**
+     * Checks whether attributes of a file with given uuid are cached.
+     * @param uuid The uuid of the file.
+     * @return true if attributes of the file are cached.
+     */
+    bool hasAttr(const std::string &uuid);
+
+    /**
+     * Puts attributes of a file fetched ahead of their use in the cache,
+     * unless attributes of the file are already cached.
+     * @param attr The attributes to cache.
+     * @return true if the attributes have been put in the cache.
+     */
+    bool putAttr(FileAttr attr);
+
     /**
      * Retrieves location data about a file with given uuid.
      * @param uuid The uuid of a file to retrieve location data about.
@@ -212,7 +388,8 @@ public:
     void remove(UuidAccessor &uuidAcc, MetaAccessor &metaAcc);
 
     /**
-     * Removes a UUID entry (path mapping) from the cache.
+     * Removes a UUID entry (path mapping) from the cache and forgets the
+     * path of the file.
      * @param uuidAcc Accessor to UUID mapping to remove.
      * @param metaAcc Accessor to metadata mapping.
      */
@@ -224,6 +401,38 @@ public:
      */
     void remove(const std::string &uuid);
 
+    /**
+     * Forgets that there is no file at a given path, e.g. after the file
+     * has been created.
+     * @param path The path of the file.
+     */
+    void forgetMissing(const Path &path);
+
+    /**
+     * Forgets that there are no files at any paths in a given directory,
+     * e.g. after the directory has been modified remotely.
+     * @param dirPath The path of the directory.
+     */
+    void forgetMissingChildren(const Path &dirPath);
+
+    /**
+     * Moves paths remembered to be missing closer to expiration, forgetting
+     * the ones that have not been looked up for @c MISSING_PATHS_TTL
+     * calls.
+     */
+    void expireMissingPaths();
+
+    /**
+     * @return Number of files with cached metadata.
+     */
+    std::size_t size() const;
+
+    /**
+     * @return Approximate number of bytes taken by cached metadata and the
+     * dentry index.
+     */
+    std::size_t footprint() const;
+
     /**
      * Waits for file location update on given condition.
      * @param uuid The UUID of file
@@ -263,17 +472,55 @@ public:
 
 private:
     /**
-     * Retrieves mutex and condition assigned to file with given uuid. Creates
-     * them, if they are not found.
-     * @param uuid The uuid of a file to get mutex and condition.
-     * @return Pair: mutex, condition.
+     * Registers a waiter for location update of a file with given uuid,
+     * creating mutex and condition for the file if nobody waits yet.
+     * @param uuid The uuid of a file to wait for.
+     * @return Waiters of the file.
      */
-    std::pair<std::mutex &, std::condition_variable &> getMutexConditionPair(
+    std::shared_ptr<LocationWaiters> addLocationWaiter(
         const std::string &uuid);
 
-    FileAttr fetchAttr(messages::ClientMessage &&request);
+    /**
+     * Unregisters a waiter for location update of a file, releasing mutex
+     * and condition of the file when the last waiter leaves.
+     * @param uuid The uuid of a file waited for.
+     */
+    void removeLocationWaiter(const std::string &uuid);
+
+    Dentry toDentry(const Path &path);
+    FileAttr fetchAttr(const std::string &uuid);
+    FileAttr resolveAttr(const Path &path);
+    FileLocation fetchLocation(
+        const std::string &uuid, const one::helpers::FlagsSet flags);
+    std::shared_ptr<Record> findRecord(const std::string &uuid);
+    bool lockRecord(MetaAccessor &metaAcc, std::shared_ptr<Record> record);
+    template <typename Read> bool readMeta(const std::string &uuid, Read &&read);
+    bool findMeta(MetaAccessor &metaAcc, const std::string &uuid);
+    bool insertMeta(MetaAccessor &metaAcc, const std::string &uuid);
+    void eraseMeta(MetaAccessor &metaAcc);
+    bool insertDentry(UuidAccessor &uuidAcc, const Dentry &dentry);
+    void eraseDentry(UuidAccessor &uuidAcc);
+    void eraseDentry(const Dentry &dentry);
+    static std::size_t dentrySize(const Dentry &dentry);
+    bool isMissing(const Path &path);
+    void markMissing(const Path &path);
+    bool eraseMissing(const Path &path);
 
     communication::Communicator &m_communicator;
+    std::atomic<std::size_t> m_dentriesSize{0};
+
+    SingleFlight<std::string, FileAttr> m_attrFlights;
+    SingleFlight<Path, FileAttr, PathHash> m_pathFlights;
+    SingleFlight<LocationKey, FileLocation, LocationKeyHash> m_locationFlights;
+
+    const std::size_t m_missingPathsLimit;
+    std::mutex m_missingPathsMutex;
+    /// Names of missing files by path of their parent directory.
+    std::unordered_map<std::string, std::unordered_set<std::string>>
+        m_missingPaths;
+    std::size_t m_missingPathsCount = 0;
+    CacheExpirationHelper<std::string, MISSING_PATHS_TTL>
+        m_missingPathsExpirationHelper;
 };
 
 } // namespace one
@@ -0,0 +1,99 @@
+/**
+ * @file singleFlight.h
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#ifndef ONECLIENT_SINGLE_FLIGHT_H
+#define ONECLIENT_SINGLE_FLIGHT_H
+
+#include "communication/layers/translator.h"
+
+#include <tbb/concurrent_hash_map.h>
+
+#include <future>
+#include <memory>
+
+namespace one {
+namespace client {
+
+/**
+ * @c SingleFlight deduplicates concurrent fetches of the same remote value.
+ * The first requester of a key launches the fetch; requesters arriving
+ * while the fetch is in flight wait for its result instead of launching
+ * their own. No lock is held while waiting, so the waiters of other keys
+ * are never blocked by a pending fetch.
+ */
+template <typename Key, typename Value,
+    typename HashCompare = tbb::tbb_hash_compare<Key>>
+class SingleFlight {
+public:
+    /**
+     * Retrieves a value, joining a fetch of the value already in flight.
+     * @param key The key of the value.
+     * @param fetch Function launching the fetch and returning
+     * @c std::future<Value>. Called only if no fetch of @p key is in flight.
+     * @return The fetched value.
+     */
+    template <typename Fetch> Value get(const Key &key, Fetch &&fetch)
+    {
+        std::shared_ptr<Flight> flight;
+        {
+            typename Flights::accessor acc;
+            if (m_flights.insert(acc, key)) {
+                try {
+                    acc->second =
+                        std::make_shared<Flight>(Flight{fetch().share()});
+                }
+                catch (...) {
+                    m_flights.erase(acc);
+                    throw;
+                }
+            }
+            flight = acc->second;
+        }
+
+        try {
+            auto value = communication::wait(flight->future);
+            land(key, flight);
+            return value;
+        }
+        catch (...) {
+            land(key, flight);
+            throw;
+        }
+    }
+
+    /**
+     * @return Number of fetches in flight.
+     */
+    std::size_t size() const { return m_flights.size(); }
+
+private:
+    struct Flight {
+        std::shared_future<Value> future;
+    };
+
+    using Flights =
+        tbb::concurrent_hash_map<Key, std::shared_ptr<Flight>, HashCompare>;
+
+    /**
+     * Removes a finished flight, unless it has already been replaced by a
+     * new one. Waiters still holding the flight keep its result.
+     */
+    void land(const Key &key, const std::shared_ptr<Flight> &flight)
+    {
+        typename Flights::accessor acc;
+        if (m_flights.find(acc, key) && acc->second == flight)
+            m_flights.erase(acc);
+    }
+
+    Flights m_flights;
+};
+
+} // namespace client
+} // namespace one
+
+#endif // ONECLIENT_SINGLE_FLIGHT_H
@@ -0,0 +1,87 @@
+/**
+ * @file syncAhead.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "syncAhead.h"
+
+#include <algorithm>
+
+namespace one {
+namespace client {
+
+SyncAhead::SyncAhead(const std::size_t minWindow, const std::size_t maxWindow)
+    : m_minWindow{std::min(minWindow, maxWindow)}
+    , m_maxWindow{maxWindow}
+    , m_window{m_minWindow}
+{
+}
+
+boost::optional<boost::icl::discrete_interval<off_t>> SyncAhead::onRead(
+    const off_t offset, const std::size_t size, const off_t fileSize)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    const off_t end = offset + size;
+    if (offset != m_nextOffset) {
+        m_window = m_minWindow;
+        m_sequentialReads = 0;
+        m_sequentialBytes = 0;
+        m_syncedEnd = end;
+    }
+
+    if (m_sequentialReads == 0)
+        m_sequentialSince = Clock::now();
+
+    ++m_sequentialReads;
+    m_sequentialBytes += size;
+    m_nextOffset = end;
+
+    // A single read does not make a stream yet
+    if (m_sequentialReads < 2 || m_window == 0)
+        return {};
+
+    const off_t start = std::max(m_syncedEnd, end);
+    const off_t target =
+        std::min<off_t>(fileSize, end + static_cast<off_t>(m_window));
+
+    // Refill the window once half of it has been consumed, unless the rest
+    // of the file is shorter than that
+    if (start >= target ||
+        (target - start < static_cast<off_t>(m_window / 2) &&
+            target < fileSize))
+        return {};
+
+    m_syncedEnd = target;
+    return boost::icl::discrete_interval<off_t>::right_open(start, target);
+}
+
+void SyncAhead::onStall(const Clock::duration latency)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    if (m_sequentialReads < 2)
+        return;
+
+    // Number of bytes the reader would consume while waiting for the data
+    std::size_t bytesPerLatency = 0;
+    const auto elapsed = Clock::now() - m_sequentialSince;
+    if (elapsed.count() > 0)
+        bytesPerLatency = static_cast<std::size_t>(m_sequentialBytes *
+            (static_cast<double>(latency.count()) / elapsed.count()));
+
+    m_window = std::min(
+        m_maxWindow, std::max(m_window * 2, bytesPerLatency * 2));
+}
+
+std::size_t SyncAhead::window() const
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    return m_window;
+}
+
+} // namespace client
+} // namespace one
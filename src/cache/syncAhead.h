@@ -0,0 +1,80 @@
+/**
+ * @file syncAhead.h
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#ifndef ONECLIENT_SYNC_AHEAD_H
+#define ONECLIENT_SYNC_AHEAD_H
+
+#include <boost/icl/discrete_interval.hpp>
+#include <boost/optional.hpp>
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+namespace one {
+namespace client {
+
+/**
+ * @c SyncAhead tracks reads of an open file and decides which ranges should
+ * be synchronized ahead of a sequential reader. The sync-ahead window starts
+ * at a minimal size and grows whenever the reader has to wait for data, so
+ * that it covers the amount of data the reader consumes during a single
+ * synchronization round trip.
+ */
+class SyncAhead {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Constructor.
+     * @param minWindow Initial size of the sync-ahead window in bytes.
+     * @param maxWindow Maximal size of the sync-ahead window in bytes.
+     */
+    SyncAhead(const std::size_t minWindow, const std::size_t maxWindow);
+
+    /**
+     * Records a read of a file.
+     * @param offset Offset of the read.
+     * @param size Number of bytes read.
+     * @param fileSize Current size of the file.
+     * @return Range that should be synchronized ahead of the reader, if any.
+     */
+    boost::optional<boost::icl::discrete_interval<off_t>> onRead(
+        const off_t offset, const std::size_t size, const off_t fileSize);
+
+    /**
+     * Records that a read had to wait for its data to be synchronized. Grows
+     * the window of a sequential reader.
+     * @param latency Time spent waiting for the data.
+     */
+    void onStall(const Clock::duration latency);
+
+    /**
+     * @return Current size of the sync-ahead window in bytes.
+     */
+    std::size_t window() const;
+
+private:
+    const std::size_t m_minWindow;
+    const std::size_t m_maxWindow;
+
+    mutable std::mutex m_mutex;
+    std::size_t m_window;
+    off_t m_nextOffset = 0;
+    off_t m_syncedEnd = 0;
+    std::size_t m_sequentialReads = 0;
+    std::size_t m_sequentialBytes = 0;
+    Clock::time_point m_sequentialSince;
+};
+
+} // namespace client
+} // namespace one
+
+#endif // ONECLIENT_SYNC_AHEAD_H
@@ -0,0 +1,42 @@
+/**
+ * @file writeAccumulator.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "writeAccumulator.h"
+
+#include <algorithm>
+
+namespace one {
+namespace client {
+
+WriteAccumulator::WriteAccumulator(one::helpers::FlagsSet flags,
+    const std::size_t maxPendingRanges,
+    std::shared_ptr<std::atomic<std::size_t>> pendingAccumulators)
+    : m_flags{std::move(flags)}
+    , m_maxPendingRanges{maxPendingRanges}
+    , m_pendingAccumulators{std::move(pendingAccumulators)}
+{
+}
+
+bool WriteAccumulator::add(const FileBlocksMap &blocks)
+{
+    if (blocks.empty())
+        return false;
+
+    std::lock_guard<std::mutex> guard{m_mutex};
+    if (m_pending.empty())
+        ++(*m_pendingAccumulators);
+
+    m_pending += blocks;
+    m_end = std::max(m_end, boost::icl::last_next(blocks.rbegin()->first));
+    m_empty = false;
+
+    return m_pending.iterative_size() >= m_maxPendingRanges;
+}
+
+} // namespace client
+} // namespace one
@@ -0,0 +1,109 @@
+/**
+ * @file writeAccumulator.h
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#ifndef ONECLIENT_WRITE_ACCUMULATOR_H
+#define ONECLIENT_WRITE_ACCUMULATOR_H
+
+#include "messages/fuse/fileLocation.h"
+
+#include <helpers/IStorageHelper.h>
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace one {
+namespace client {
+
+/**
+ * @c WriteAccumulator collects blocks written through an open file handle,
+ * so that they can be published to the metadata cache in batches instead of
+ * on every write. Blocks written sequentially to the same storage file merge
+ * into a single range, so the accumulator stays compact. A counter shared by
+ * the accumulators of a file tracks how many of them hold pending blocks, so
+ * that readers can skip publishing when there are none.
+ */
+class WriteAccumulator {
+public:
+    using FileBlocksMap = messages::fuse::FileLocation::FileBlocksMap;
+
+    /**
+     * Constructor.
+     * @param flags Flags of the handle, selecting the file location the
+     * blocks belong to.
+     * @param maxPendingRanges Number of pending ranges at which the blocks
+     * should be published.
+     * @param pendingAccumulators Counter of accumulators with pending blocks,
+     * incremented when the accumulator gets pending blocks and decremented
+     * when they are published.
+     */
+    WriteAccumulator(one::helpers::FlagsSet flags,
+        const std::size_t maxPendingRanges,
+        std::shared_ptr<std::atomic<std::size_t>> pendingAccumulators =
+            std::make_shared<std::atomic<std::size_t>>(0));
+
+    /**
+     * @return Flags of the handle.
+     */
+    const one::helpers::FlagsSet &flags() const { return m_flags; }
+
+    /**
+     * Records written blocks.
+     * @param blocks The written blocks.
+     * @return true if the pending blocks should be published.
+     */
+    bool add(const FileBlocksMap &blocks);
+
+    /**
+     * @return true if there are no pending blocks.
+     */
+    bool empty() const { return m_empty; }
+
+    /**
+     * Publishes pending blocks. The accumulator stays locked until the
+     * blocks are published, so that no one can observe them missing both
+     * from the accumulator and from their destination. The blocks remain
+     * pending if @p publish throws.
+     * @param publish Callable taking the pending blocks and the end offset
+     * of the last of them.
+     */
+    template <typename PublishFun> void flush(PublishFun &&publish)
+    {
+        if (m_empty)
+            return;
+
+        std::lock_guard<std::mutex> guard{m_mutex};
+        if (m_pending.empty())
+            return;
+
+        publish(static_cast<const FileBlocksMap &>(m_pending), m_end);
+
+        m_pending.clear();
+        m_end = 0;
+        m_empty = true;
+        --(*m_pendingAccumulators);
+    }
+
+private:
+    const one::helpers::FlagsSet m_flags;
+    const std::size_t m_maxPendingRanges;
+    const std::shared_ptr<std::atomic<std::size_t>> m_pendingAccumulators;
+
+    std::mutex m_mutex;
+    FileBlocksMap m_pending;
+    off_t m_end = 0;
+    std::atomic<bool> m_empty{true};
+};
+
+} // namespace client
+} // namespace one
+
+#endif // ONECLIENT_WRITE_ACCUMULATOR_H
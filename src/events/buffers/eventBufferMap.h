@@ -37,6 +37,8 @@ public:
     /**
      * @copydoc EventBuffer::push(EventPtr)
      * Aggregates events with the same key (@see e.g. @c ReadEvent::Key).
+     * An aggregated event which becomes full (@see e.g. @c WriteEvent::full)
+     * is removed from the buffer and passed to the @c EventHandler at once.
      */
     void push(EventPtr event) override;
 
@@ -65,7 +67,14 @@ template <class EventT> void EventBufferMap<EventT>::push(EventPtr event)
         it->second->aggregate(std::move(event));
     else {
         auto key = event->key();
-        m_buffer.emplace(key, std::move(event));
+        it = m_buffer.emplace(key, std::move(event)).first;
+    }
+
+    if (it->second->full()) {
+        std::vector<EventPtr> events;
+        events.emplace_back(std::move(it->second));
+        m_buffer.erase(it);
+        m_onClearHandler(std::move(events));
     }
 }
 
@@ -0,0 +1,253 @@
+/**
+ * @file threadLocalEventBuffer.h
+ * @author Krzysztof Trzepla
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#ifndef ONECLIENT_EVENTS_BUFFERS_THREAD_LOCAL_EVENT_BUFFER_H
+#define ONECLIENT_EVENTS_BUFFERS_THREAD_LOCAL_EVENT_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace one {
+namespace client {
+namespace events {
+
+/**
+ * @c ThreadLocalEventBuffer aggregates events by key in buffers private to
+ * the emitting threads, so that frequently emitted events are merged before
+ * being handed over to an event stream. An aggregated event is passed to the
+ * handler once its counter reaches the counter threshold or it becomes full,
+ * or when the buffer is flushed. The buffer of a thread is locked only by the
+ * thread itself and by flushes, so pushes are not contended by other emitting
+ * threads. Buffers of exited threads are dropped by flushes, and buffers of
+ * destroyed instances are dropped by threads creating new buffers.
+ */
+template <class EventT> class ThreadLocalEventBuffer {
+public:
+    using EventPtr = typename EventT::EventPtr;
+    using Key = typename EventT::Key;
+    using EventHandler = std::function<void(EventPtr)>;
+
+    /**
+     * Constructor.
+     * @param counterThreshold Number of events aggregated in a thread's buffer
+     * after which the aggregated event is passed to the handler.
+     * @param handler Handler called with aggregated events.
+     */
+    ThreadLocalEventBuffer(std::size_t counterThreshold, EventHandler handler)
+        : m_counterThreshold{counterThreshold}
+        , m_handler{std::move(handler)}
+    {
+    }
+
+    /**
+     * Destructor.
+     * Passes all pending events to the handler.
+     */
+    ~ThreadLocalEventBuffer();
+
+    /**
+     * Aggregates an event in the calling thread's buffer.
+     * @param event Event to be aggregated.
+     */
+    void push(EventPtr event);
+
+    /**
+     * Aggregates an event in place in the calling thread's buffer, so that an
+     * event is allocated only for a key not yet pending in the buffer.
+     * @param key Key of the event.
+     * @param create Callable returning a new @c EventPtr for the key.
+     * @param aggregate Callable aggregating the event into a pending
+     * @c EventT& with the key.
+     */
+    template <class Create, class Aggregate>
+    void emplace(const Key &key, Create &&create, Aggregate &&aggregate);
+
+    /**
+     * Passes pending events with a given key, aggregated by any thread, to the
+     * handler.
+     * @param key Key of events to be flushed.
+     */
+    void flush(const Key &key);
+
+    /**
+     * Passes all pending events to the handler.
+     */
+    void flush();
+
+private:
+    struct LocalBuffer {
+        std::mutex mutex;
+        std::unordered_map<Key, EventPtr> events;
+        std::atomic<bool> released{false};
+    };
+
+    using EventsIt = typename std::unordered_map<Key, EventPtr>::iterator;
+
+    void handOver(LocalBuffer &buffer, EventPtr event, EventsIt it,
+        std::unique_lock<std::mutex> &lock);
+
+    LocalBuffer &localBuffer();
+
+    static std::uint64_t nextId()
+    {
+        static std::atomic<std::uint64_t> id{0};
+        return id++;
+    }
+
+    const std::uint64_t m_id = nextId();
+    const std::size_t m_counterThreshold;
+    EventHandler m_handler;
+    std::mutex m_buffersMutex;
+    std::vector<std::shared_ptr<LocalBuffer>> m_buffers;
+};
+
+template <class EventT>
+ThreadLocalEventBuffer<EventT>::~ThreadLocalEventBuffer()
+{
+    flush();
+
+    std::lock_guard<std::mutex> guard{m_buffersMutex};
+    for (auto &buffer : m_buffers)
+        buffer->released = true;
+}
+
+template <class EventT>
+void ThreadLocalEventBuffer<EventT>::push(EventPtr event)
+{
+    auto &buffer = localBuffer();
+    std::unique_lock<std::mutex> lock{buffer.mutex};
+
+    auto it = buffer.events.find(event->key());
+    if (it != buffer.events.end())
+        it->second->aggregate(std::move(event));
+
+    handOver(buffer, std::move(event), it, lock);
+}
+
+template <class EventT>
+template <class Create, class Aggregate>
+void ThreadLocalEventBuffer<EventT>::emplace(
+    const Key &key, Create &&create, Aggregate &&aggregate)
+{
+    auto &buffer = localBuffer();
+    std::unique_lock<std::mutex> lock{buffer.mutex};
+
+    EventPtr event;
+    auto it = buffer.events.find(key);
+    if (it == buffer.events.end())
+        event = create();
+    else
+        aggregate(*it->second);
+
+    handOver(buffer, std::move(event), it, lock);
+}
+
+template <class EventT>
+void ThreadLocalEventBuffer<EventT>::handOver(LocalBuffer &buffer,
+    EventPtr event, EventsIt it, std::unique_lock<std::mutex> &lock)
+{
+    if (it == buffer.events.end()) {
+        if (event->counter() < m_counterThreshold && !event->full()) {
+            auto key = event->key();
+            buffer.events.emplace(std::move(key), std::move(event));
+            return;
+        }
+    }
+    else {
+        if (it->second->counter() < m_counterThreshold &&
+            !it->second->full())
+            return;
+
+        event = std::move(it->second);
+        buffer.events.erase(it);
+    }
+
+    lock.unlock();
+    m_handler(std::move(event));
+}
+
+template <class EventT>
+void ThreadLocalEventBuffer<EventT>::flush(const Key &key)
+{
+    std::lock_guard<std::mutex> guard{m_buffersMutex};
+    for (auto &buffer : m_buffers) {
+        EventPtr event;
+        {
+            std::lock_guard<std::mutex> bufferGuard{buffer->mutex};
+            auto it = buffer->events.find(key);
+            if (it == buffer->events.end())
+                continue;
+
+            event = std::move(it->second);
+            buffer->events.erase(it);
+        }
+        m_handler(std::move(event));
+    }
+}
+
+template <class EventT> void ThreadLocalEventBuffer<EventT>::flush()
+{
+    std::lock_guard<std::mutex> guard{m_buffersMutex};
+    for (auto &buffer : m_buffers) {
+        std::unordered_map<Key, EventPtr> events;
+        {
+            std::lock_guard<std::mutex> bufferGuard{buffer->mutex};
+            events.swap(buffer->events);
+        }
+        for (auto &entry : events)
+            m_handler(std::move(entry.second));
+    }
+
+    // A buffer referenced only by this instance belongs to an exited thread
+    m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(),
+                        [](const auto &buffer) {
+                            return buffer.use_count() == 1 &&
+                                buffer->events.empty();
+                        }),
+        m_buffers.end());
+}
+
+template <class EventT>
+typename ThreadLocalEventBuffer<EventT>::LocalBuffer &
+ThreadLocalEventBuffer<EventT>::localBuffer()
+{
+    // Buffers are looked up by the ID of the owning instance, as an address
+    // of a destroyed instance may be reused by a new one.
+    static thread_local std::unordered_map<std::uint64_t,
+        std::shared_ptr<LocalBuffer>>
+        buffers;
+
+    auto &buffer = buffers[m_id];
+    if (!buffer) {
+        for (auto it = buffers.begin(); it != buffers.end();) {
+            if (it->second && it->second->released)
+                it = buffers.erase(it);
+            else
+                ++it;
+        }
+
+        // Erasing other entries does not invalidate the reference
+        buffer = std::make_shared<LocalBuffer>();
+        std::lock_guard<std::mutex> guard{m_buffersMutex};
+        m_buffers.emplace_back(buffer);
+    }
+
+    return *buffer;
+}
+
+} // namespace events
+} // namespace client
+} // namespace one
+
+#endif // ONECLIENT_EVENTS_BUFFERS_THREAD_LOCAL_EVENT_BUFFER_H
@@ -13,8 +13,10 @@
 #include "events/buffers/voidEventBuffer.h"
 #include "events/eventContainer.h"
 #include "events/subscriptions/subscriptionCancellation.h"
+#include "logging.h"
 
 #include <functional>
+#include <limits>
 #include <unordered_map>
 #include <vector>
 
@@ -25,6 +27,13 @@ namespace events {
 /**
  * @c EventCommunicator is responsible for sending events and subscriptions to
  * the server. It is a wrapper on @c one::communication::StreamManager::Stream.
+ * While the stream keeps more unacknowledged messages than allowed, events are
+ * not sent but aggregated by key with events deferred earlier. Deferred events
+ * are sent once the stream drains, checked by the next send or by a flush
+ * scheduled through the deferred flush handler. Once the estimated footprint
+ * of deferred events reaches the limit of the stream, they are collapsed, and
+ * events of new keys which still do not fit are dropped, so that neither the
+ * deferred events nor the stream grow without bound.
  */
 template <class EventType> class EventCommunicator {
 public:
@@ -33,6 +42,7 @@ public:
     using Subscription = typename EventT::Subscription;
     using SubscriptionPtr = std::unique_ptr<Subscription>;
     using StreamPtr = std::shared_ptr<communication::StreamManager::Stream>;
+    using DeferredFlushHandler = std::function<void(std::function<void()>)>;
 
     /**
      * A reference to @c *this typed as a @c EventCommunicator.
@@ -52,11 +62,35 @@ public:
     virtual ~EventCommunicator();
 
     /**
-     * Sends events to the server.
+     * Sends events to the server, together with events deferred earlier.
+     * Defers the events if the stream is saturated.
      * @param events Events to be sent.
      */
     void send(std::vector<EventPtr> &&events);
 
+    /**
+     * @return Number of events dropped since deferred events were last sent.
+     */
+    std::size_t droppedEvents() const;
+
+    /**
+     * Sets the maximal size of messages kept by the stream until they are
+     * acknowledged, above which events are deferred. It also limits the
+     * estimated footprint of deferred events, above which they are collapsed
+     * and events of new keys are dropped.
+     * @param size Maximal size in bytes.
+     */
+    void setMaxBufferedSize(std::size_t size);
+
+    /**
+     * Sets a handler called with a flush function when events are deferred.
+     * The handler should call the function after a while; it sends deferred
+     * events if the stream is no longer saturated, otherwise it calls the
+     * handler again.
+     * @param handler Handler to be set.
+     */
+    void setDeferredFlushHandler(DeferredFlushHandler handler);
+
     /**
      * Sends a subscription to the server.
      * @param subscription Subscription to be sent.
@@ -70,7 +104,21 @@ public:
     void send(SubscriptionCancellation &&cancellation);
 
 private:
+    bool saturated() const;
+    void defer(EventPtr event);
+    void collapseDeferred();
+    void flushDeferred();
+    void sendDeferred();
+    void scheduleDeferredFlush();
+
     StreamPtr m_stream;
+    std::size_t m_maxBufferedSize = std::numeric_limits<std::size_t>::max();
+    std::unordered_map<typename EventT::Key, EventPtr> m_deferredEvents;
+    std::size_t m_deferredSize = 0;
+    bool m_deferredCollapsed = false;
+    std::size_t m_droppedEvents = 0;
+    bool m_deferredFlushScheduled = false;
+    DeferredFlushHandler m_deferredFlushHandler = [](auto) {};
 };
 
 template <class EventT>
@@ -87,8 +135,128 @@ template <class EventT> EventCommunicator<EventT>::~EventCommunicator()
 template <class EventT>
 void EventCommunicator<EventT>::send(std::vector<EventPtr> &&events)
 {
-    if (!events.empty())
-        m_stream->send(EventContainer<EventT>{std::move(events)});
+    if (m_deferredEvents.empty() && !saturated()) {
+        if (!events.empty())
+            m_stream->send(EventContainer<EventT>{std::move(events)});
+        return;
+    }
+
+    for (auto &event : events)
+        defer(std::move(event));
+
+    if (m_deferredEvents.empty() && m_droppedEvents == 0)
+        return;
+
+    if (saturated())
+        scheduleDeferredFlush();
+    else
+        sendDeferred();
+}
+
+template <class EventT>
+std::size_t EventCommunicator<EventT>::droppedEvents() const
+{
+    return m_droppedEvents;
+}
+
+template <class EventT> void EventCommunicator<EventT>::defer(EventPtr event)
+{
+    auto it = m_deferredEvents.find(event->key());
+    const bool inserted = it == m_deferredEvents.end();
+    if (inserted) {
+        auto key = event->key();
+        it = m_deferredEvents.emplace(std::move(key), std::move(event)).first;
+    }
+    else {
+        m_deferredSize -= it->second->footprint();
+        it->second->aggregate(std::move(event));
+    }
+
+    if (m_deferredCollapsed)
+        it->second->collapse();
+
+    m_deferredSize += it->second->footprint();
+    if (m_deferredSize < m_maxBufferedSize)
+        return;
+
+    if (!m_deferredCollapsed)
+        collapseDeferred();
+
+    // Events of known keys are kept, as they have been collapsed already
+    if (m_deferredSize >= m_maxBufferedSize && inserted) {
+        if (m_droppedEvents == 0)
+            LOG(WARNING) << "Dropping events as deferred events reached "
+                         << m_maxBufferedSize << " bytes";
+
+        m_droppedEvents += it->second->counter();
+        m_deferredSize -= it->second->footprint();
+        m_deferredEvents.erase(it);
+    }
+}
+
+template <class EventT> void EventCommunicator<EventT>::collapseDeferred()
+{
+    m_deferredCollapsed = true;
+    m_deferredSize = 0;
+    for (auto &entry : m_deferredEvents) {
+        entry.second->collapse();
+        m_deferredSize += entry.second->footprint();
+    }
+}
+
+template <class EventT> void EventCommunicator<EventT>::flushDeferred()
+{
+    m_deferredFlushScheduled = false;
+    send(std::vector<EventPtr>{});
+}
+
+template <class EventT> void EventCommunicator<EventT>::sendDeferred()
+{
+    if (m_droppedEvents > 0)
+        LOG(WARNING) << "Dropped " << m_droppedEvents
+                     << " events while the event stream was saturated";
+
+    m_droppedEvents = 0;
+    m_deferredCollapsed = false;
+    if (m_deferredEvents.empty())
+        return;
+
+    std::vector<EventPtr> deferredEvents;
+    deferredEvents.reserve(m_deferredEvents.size());
+    for (auto &entry : m_deferredEvents)
+        deferredEvents.emplace_back(std::move(entry.second));
+    m_deferredEvents.clear();
+    m_deferredSize = 0;
+
+    m_stream->send(EventContainer<EventT>{std::move(deferredEvents)});
+}
+
+template <class EventT>
+void EventCommunicator<EventT>::scheduleDeferredFlush()
+{
+    if (m_deferredFlushScheduled)
+        return;
+
+    m_deferredFlushScheduled = true;
+    m_deferredFlushHandler([this] { flushDeferred(); });
+}
+
+template <class EventT>
+void EventCommunicator<EventT>::setMaxBufferedSize(std::size_t size)
+{
+    m_maxBufferedSize = size;
+}
+
+template <class EventT>
+void EventCommunicator<EventT>::setDeferredFlushHandler(
+    DeferredFlushHandler handler)
+{
+    m_deferredFlushHandler = std::move(handler);
+}
+
+template <class EventT> bool EventCommunicator<EventT>::saturated() const
+{
+    return m_stream->bufferedSize() >= m_maxBufferedSize;
 }
 
 template <class EventT>
@@ -13,6 +13,8 @@
 #include "events/types/writeEvent.h"
 #include "messages/clientMessage.h"
 
+#include "messages.pb.h"
+
 #include <memory>
 #include <sstream>
 #include <vector>
@@ -57,10 +59,12 @@ EventContainer<EventT>::serializeAndDestroy()
     auto clientMsg = std::make_unique<messages::ProtocolClientMessage>();
     auto eventsMsg = clientMsg->mutable_events();
 
-    for (auto &event : m_events) {
-        auto eventMsg = eventsMsg->add_events();
-        eventMsg->Swap(event->serializeAndDestroy().release());
-    }
+    // Serialized events are adopted by the container message, so that each
+    // of them is allocated only once.
+    eventsMsg->mutable_events()->Reserve(m_events.size());
+    for (auto &event : m_events)
+        eventsMsg->mutable_events()->AddAllocated(
+            event->serializeAndDestroy().release());
 
     return clientMsg;
 }
@@ -10,38 +10,61 @@
 
 #include "communication/subscriptionData.h"
 #include "context.h"
+#include "options.h"
 #include "scheduler.h"
 #include "subscriptionRegistry.h"
 #include "subscriptions/subscriptionCancellation.h"
+#include "utils.hpp"
 
 #include "messages.pb.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
 namespace one {
 namespace client {
 namespace events {
 
+namespace {
+/// Number of read or write events of a file aggregated by an emitting thread
+/// before they are handed over to the event stream.
+constexpr std::size_t LOCAL_EVENTS_COUNTER_THRESHOLD = 64;
+
+/// Interval of handing over events aggregated by emitting threads to the
+/// event streams, regardless of their number.
+constexpr std::chrono::milliseconds LOCAL_EVENTS_FLUSH_INTERVAL{100};
+}
+
 EventManager::EventManager(std::shared_ptr<Context> context)
     : m_streamManager{context->communicator()}
     , m_registry{std::make_shared<SubscriptionRegistry>()}
     , m_readEventStream{std::make_unique<ReadEventStream>(
-          m_streamManager.create())}
+          m_ioService, m_streamManager.create())}
     , m_writeEventStream{std::make_unique<WriteEventStream>(
-          m_streamManager.create())}
+          m_ioService, m_streamManager.create())}
     , m_fileAttrEventStream{std::make_unique<FileAttrEventStream>(
-          m_streamManager.create())}
+          m_ioService, m_streamManager.create())}
     , m_fileLocationEventStream{std::make_unique<FileLocationEventStream>(
-          m_streamManager.create())}
+          m_ioService, m_streamManager.create())}
     , m_permissionChangedEventStream{std::make_unique<
-          PermissionChangedEventStream>(m_streamManager.create())}
+          PermissionChangedEventStream>(m_ioService, m_streamManager.create())}
     , m_fileRemovalEventStream{std::make_unique<FileRemovalEventStream>(
-          m_streamManager.create())}
-    , m_quotaExeededEventStream{
-          std::make_unique<QuotaExeededEventStream>(m_streamManager.create())}
-    , m_fileRenamedEventStream{
-          std::make_unique<FileRenamedEventStream>(m_streamManager.create())}
-    , m_fileAccessedEventStream{
-          std::make_unique<FileAccessedEventStream>(m_streamManager.create())}
-
+          m_ioService, m_streamManager.create())}
+    , m_quotaExeededEventStream{std::make_unique<QuotaExeededEventStream>(
+          m_ioService, m_streamManager.create())}
+    , m_fileRenamedEventStream{std::make_unique<FileRenamedEventStream>(
+          m_ioService, m_streamManager.create())}
+    , m_fileAccessedEventStream{std::make_unique<FileAccessedEventStream>(
+          m_ioService, m_streamManager.create())}
+    , m_localReadEvents{LOCAL_EVENTS_COUNTER_THRESHOLD,
+          [this](auto event) {
+              m_readEventStream->emitEvent(std::move(event));
+          }}
+    , m_localWriteEvents{LOCAL_EVENTS_COUNTER_THRESHOLD,
+          [this](auto event) {
+              m_writeEventStream->emitEvent(std::move(event));
+          }}
 {
     auto predicate = [](const clproto::ServerMessage &message, const bool) {
         return message.has_events() || message.has_subscription() ||
@@ -58,25 +81,78 @@ EventManager::EventManager(std::shared_ptr<Context> context)
     context->communicator()->subscribe(communication::SubscriptionData{
         std::move(predicate), std::move(callback)});
 
+    if (auto options = context->options()) {
+        auto limits = std::make_shared<WriteEvent::FragmentationLimits>();
+        limits->maxBlocks = options->get_write_event_max_blocks();
+        limits->coalesceBlocks = options->get_write_event_coalesce_blocks();
+        limits->coalesceGap = options->get_write_event_coalesce_gap();
+        m_writeEventLimits = std::move(limits);
+
+        const auto maxBufferedSize =
+            options->get_event_stream_buffer_max_size();
+        m_readEventStream->communicator.setMaxBufferedSize(maxBufferedSize);
+        m_writeEventStream->communicator.setMaxBufferedSize(maxBufferedSize);
+        m_fileAccessedEventStream->communicator.setMaxBufferedSize(
+            maxBufferedSize);
+    }
+
+    startWorkers(*context);
     initializeStreams(std::move(context));
+    scheduleLocalEventsFlush();
+}
+
+EventManager::~EventManager()
+{
+    m_localReadEvents.flush();
+    m_localWriteEvents.flush();
+    m_readEventStream->flush();
+    m_writeEventStream->flush();
+    m_fileAccessedEventStream->flush();
+    m_ioService.stop();
+    for (auto &worker : m_workers)
+        worker.join();
 }
 
 void EventManager::emitReadEvent(
-    off_t offset, size_t size, std::string fileUuid) const
+    off_t offset, size_t size, const std::string &fileUuid) const
 {
-    m_readEventStream->createAndEmitEvent(offset, size, std::move(fileUuid));
+    m_localReadEvents.emplace(fileUuid,
+        [&] { return std::make_unique<ReadEvent>(offset, size, fileUuid); },
+        [&](ReadEvent &event) { event.aggregate(offset, size); });
 }
 
 void EventManager::emitWriteEvent(off_t offset, std::size_t size,
-    std::string fileUuid, std::string storageId, std::string fileId) const
+    const std::string &fileUuid, const std::string &storageId,
+    const std::string &fileId) const
 {
-    m_writeEventStream->createAndEmitEvent(offset, size, std::move(fileUuid),
-        std::move(storageId), std::move(fileId));
+    WriteEvent::FileBlocksMap blocks{
+        {boost::icl::discrete_interval<off_t>::right_open(
+             offset, offset + size),
+            WriteEvent::FileBlock{storageId, fileId}}};
+
+    emitWriteEvent(size, fileUuid, blocks);
+}
+
+void EventManager::emitWriteEvent(std::size_t size,
+    const std::string &fileUuid, const WriteEvent::FileBlocksMap &blocks) const
+{
+    m_localWriteEvents.emplace(fileUuid,
+        [&] {
+            auto event = std::make_unique<WriteEvent>(size, fileUuid, blocks);
+            event->setFragmentationLimits(m_writeEventLimits);
+            return event;
+        },
+        [&](WriteEvent &event) { event.aggregate(size, blocks); });
 }
 
 void EventManager::emitTruncateEvent(off_t fileSize, std::string fileUuid) const
 {
-    m_writeEventStream->createAndEmitEvent(0, 0, fileSize, std::move(fileUuid));
+    m_localWriteEvents.flush(fileUuid);
+
+    auto event =
+        std::make_unique<WriteEvent>(0, 0, fileSize, std::move(fileUuid));
+    event->setFragmentationLimits(m_writeEventLimits);
+    m_writeEventStream->emitEvent(std::move(event));
 }
 
 void EventManager::setFileAttrHandler(FileAttrEventStream::Handler handler)
@@ -141,6 +217,8 @@ void EventManager::emitFileOpenedEvent(std::string fileUuid) const
 
 void EventManager::emitFileReleasedEvent(std::string fileUuid) const
 {
+    m_localReadEvents.flush(fileUuid);
+    m_localWriteEvents.flush(fileUuid);
     m_fileAccessedEventStream->createAndEmitEvent(std::move(fileUuid), 0, 1);
 }
 
@@ -256,6 +334,34 @@ std::shared_ptr<SubscriptionRegistry> EventManager::subscriptionRegistry() const
     return m_registry;
 }
 
+void EventManager::startWorkers(const Context &context)
+{
+    auto options = context.options();
+    const auto workersNo = options && options->get_event_threads() > 1
+        ? options->get_event_threads()
+        : 1;
+
+    std::generate_n(std::back_inserter(m_workers), workersNo, [this] {
+        return std::thread{[this] {
+            etls::utils::nameThread("EventWorker");
+            m_ioService.run();
+        }};
+    });
+}
+
+void EventManager::scheduleLocalEventsFlush()
+{
+    m_flushTimer.expires_after(LOCAL_EVENTS_FLUSH_INTERVAL);
+    m_flushTimer.async_wait([this](const std::error_code &ec) {
+        if (ec)
+            return;
+
+        m_localReadEvents.flush();
+        m_localWriteEvents.flush();
+        scheduleLocalEventsFlush();
+    });
+}
+
 void EventManager::initializeStreams(std::shared_ptr<Context> context)
 {
     m_readEventStream->setScheduler(context->scheduler());
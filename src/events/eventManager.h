@@ -9,14 +9,21 @@
 #ifndef ONECLIENT_EVENTS_EVENT_MANAGER_H
 #define ONECLIENT_EVENTS_EVENT_MANAGER_H
 
+#include "events/buffers/threadLocalEventBuffer.h"
 #include "events/eventStream.h"
 #include "subscriptionContainer.h"
 
 #include <sys/types.h>
 
+#include <asio/executor_work.hpp>
+#include <asio/io_service.hpp>
+#include <asio/steady_timer.hpp>
+
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace one {
 namespace clproto {
@@ -44,7 +51,13 @@ public:
      */
     EventManager(std::shared_ptr<Context> context);
 
-    virtual ~EventManager() = default;
+    /**
+     * Destructor.
+     * Emits read, write and file accessed events pending in emitting threads'
+     * buffers and in the streams, then stops the IO service shared by event
+     * streams and joins its threads.
+     */
+    virtual ~EventManager();
 
     /**
      * Emits a read event.
@@ -54,7 +67,7 @@ public:
      * @param fileUuid UUID of file associated with a read operation.
      */
     void emitReadEvent(
-        off_t offset, std::size_t size, std::string fileUuid) const;
+        off_t offset, std::size_t size, const std::string &fileUuid) const;
 
     /**
      * Emits a write event.
@@ -66,11 +79,24 @@ public:
      * @param fileId ID of a file on the storage where a write operation
      * occurred.
      */
-    void emitWriteEvent(off_t offset, std::size_t size, std::string fileUuid,
-        std::string storageId, std::string fileId) const;
+    void emitWriteEvent(off_t offset, std::size_t size,
+        const std::string &fileUuid, const std::string &storageId,
+        const std::string &fileId) const;
+
+    /**
+     * Emits a write event spanning several file blocks.
+     * @param size Number of bytes written.
+     * @param fileUuid UUID of a file associated with a write operation.
+     * @param blocks Written ranges mapped to storage IDs and file IDs where
+     * the write operation occurred.
+     */
+    void emitWriteEvent(std::size_t size, const std::string &fileUuid,
+        const WriteEvent::FileBlocksMap &blocks) const;
 
     /**
      * Emits a truncate event.
+     * Write events of the file pending in emitting threads' buffers are
+     * handed over to the write event stream first.
      * @param fileSize Size of file after a truncate operation.
      * @param fileUuid UUID of file associated with a truncate operation.
      */
@@ -155,6 +181,8 @@ public:
 
     /**
      * Emits a file accessed event with release counter set to one.
+     * Read and write events of the file pending in emitting threads' buffers
+     * are handed over to their event streams first.
      * @param fileUuid UUID of accessed file.
      */
     void emitFileReleasedEvent(std::string fileUuid) const;
@@ -225,6 +253,11 @@ public:
 protected:
     communication::StreamManager m_streamManager;
     std::shared_ptr<SubscriptionRegistry> m_registry;
+    asio::io_service m_ioService;
+    asio::executor_work<asio::io_service::executor_type> m_idleWork =
+        asio::make_work(m_ioService);
+    std::vector<std::thread> m_workers;
+    asio::steady_timer m_flushTimer{m_ioService};
     std::unique_ptr<ReadEventStream> m_readEventStream;
     std::unique_ptr<WriteEventStream> m_writeEventStream;
     std::unique_ptr<FileAttrEventStream> m_fileAttrEventStream;
@@ -235,8 +268,15 @@ protected:
     std::unique_ptr<QuotaExeededEventStream> m_quotaExeededEventStream;
     std::unique_ptr<FileRenamedEventStream> m_fileRenamedEventStream;
     std::unique_ptr<FileAccessedEventStream> m_fileAccessedEventStream;
+    mutable ThreadLocalEventBuffer<ReadEvent> m_localReadEvents;
+    mutable ThreadLocalEventBuffer<WriteEvent> m_localWriteEvents;
+    /// Limits of fragmentation of emitted write events
+    WriteEvent::FragmentationLimitsPtr m_writeEventLimits =
+        std::make_shared<WriteEvent::FragmentationLimits>();
 
 private:
+    void startWorkers(const Context &context);
+    void scheduleLocalEventsFlush();
     void initializeStreams(std::shared_ptr<Context> context);
 };
 
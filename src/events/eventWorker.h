@@ -10,23 +10,26 @@
 #define ONECLIENT_EVENTS_EVENT_WORKER_H
 
 #include "subscriptionRegistry.h"
-#include "utils.hpp"
 
-#include <asio/executor_work.hpp>
 #include <asio/io_service.hpp>
 #include <asio/io_service_strand.hpp>
 #include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
 
+#include <chrono>
 #include <functional>
-#include <thread>
+#include <future>
 
 namespace one {
 namespace client {
 namespace events {
 
 /**
- * @c EventWorker is a wrapper on @c asio::io_service. It is responsible for
- * processing events on dedicated worker thread.
+ * @c EventWorker is a wrapper on @c asio::io_service::strand. It is
+ * responsible for processing events on an @c asio::io_service shared by all
+ * event streams. The strand guarantees that the events of a single stream are
+ * processed sequentially and in order of emission, although not necessarily
+ * by the same thread.
  */
 template <class LowerLayer> class EventWorker : public LowerLayer {
 public:
@@ -37,48 +40,70 @@ public:
 
     /**
      * Constructor.
-     * Calls @c LowerLayer constructor and sets up IO service.
+     * Calls @c LowerLayer constructor and sets up a strand on the shared IO
+     * service.
+     * @param ioService IO service running the processing of events.
      */
     template <class... Args>
-    EventWorker(Args &&... args)
+    EventWorker(asio::io_service &ioService, Args &&... args)
         : LowerLayer{std::forward<Args>(args)...}
-        , m_ioService{1}
-        , m_idleWork{asio::make_work(m_ioService)}
-        , m_worker{[=] {
-            etls::utils::nameThread("EventWorker");
-            m_ioService.run();
-        }}
+        , m_strand{ioService}
+        , m_deferredFlushTimer{ioService}
     {
         LowerLayer::setPeriodicTriggerHandler([this] {
-            asio::post(m_ioService, [this] { LowerLayer::trigger(); });
+            asio::post(m_strand, [this] { LowerLayer::trigger(); });
+        });
+        LowerLayer::setDeferredFlushHandler([this](auto flush) {
+            m_deferredFlushTimer.expires_after(m_deferredFlushInterval);
+            m_deferredFlushTimer.async_wait(
+                [ this, flush = std::move(flush) ](const std::error_code &ec) {
+                    if (!ec)
+                        asio::post(m_strand, flush);
+                });
         });
     }
 
     /**
      * Destructor.
-     * Stops the IO service and joins worker thread.
+     * Waits for the events already posted to the strand to be processed,
+     * unless the shared IO service has been stopped or the worker is
+     * destroyed by a handler running on it outside of the strand.
      */
     virtual ~EventWorker();
 
     /**
      * Wraps lower layer's @c process.
-     * Processes an event on the worker thread.
+     * Processes an event on the stream's strand.
      */
     void emitEvent(EventT event);
 
     /**
      * Wraps lower layer's @c process.
-     * Creates an event and processes it on the worker thread.
+     * Processes an already allocated event on the stream's strand.
+     */
+    void emitEvent(EventPtr event);
+
+    /**
+     * Wraps lower layer's @c process.
+     * Creates an event and processes it on the stream's strand.
      */
     template <class... Args> void createAndEmitEvent(Args &&... args)
     {
-        asio::post(m_ioService,
+        asio::post(m_strand,
             [=] { LowerLayer::process(std::make_unique<EventT>(args...)); });
     }
 
+    /**
+     * Wraps lower layer's @c trigger.
+     * Emits events aggregated by the stream on the stream's strand and waits
+     * for the emission, unless the shared IO service has been stopped or
+     * the call comes from a handler running on it outside of the strand.
+     */
+    void flush();
+
     /**
      * Wraps lower layer's @c subscribe.
-     * Processes subscription on the worker thread and registers unsubscribe
+     * Processes subscription on the stream's strand and registers unsubscribe
      * handler in the @c SubscriptionRegistry.
      * @param subscription A subscription to be added.
      */
@@ -94,37 +119,83 @@ public:
     void setSubscriptionRegistry(RegistryPtr registry);
 
 private:
-    asio::io_service m_ioService;
-    asio::executor_work<asio::io_service::executor_type> m_idleWork;
-    std::thread m_worker;
+    /**
+     * Runs a function on the stream's strand and waits for it to return.
+     * The function is called directly from the strand itself. It is not
+     * called at all from other handlers of the shared IO service, as the
+     * strand may need the very thread that would wait for it.
+     */
+    template <class F> void runOnStrand(F &&f);
+
+    asio::io_service::strand m_strand;
+    asio::steady_timer m_deferredFlushTimer;
+    /// Interval of checking whether events deferred by a saturated
+    /// communication stream can be sent.
+    const std::chrono::milliseconds m_deferredFlushInterval{100};
     RegistryPtr m_registry;
 };
 
 template <class LowerLayer> EventWorker<LowerLayer>::~EventWorker()
 {
-    m_ioService.stop();
-    m_worker.join();
+    runOnStrand([this] { m_deferredFlushTimer.cancel(); });
+}
+
+template <class LowerLayer> void EventWorker<LowerLayer>::flush()
+{
+    runOnStrand([this] { LowerLayer::trigger(); });
+}
+
+template <class LowerLayer>
+template <class F>
+void EventWorker<LowerLayer>::runOnStrand(F &&f)
+{
+    auto &ioService = m_strand.context();
+    if (ioService.stopped())
+        return;
+
+    if (m_strand.running_in_this_thread()) {
+        f();
+        return;
+    }
+
+    if (ioService.get_executor().running_in_this_thread())
+        return;
+
+    std::promise<void> done;
+    asio::post(m_strand, [&] {
+        f();
+        done.set_value();
+    });
+    done.get_future().wait();
 }
 
 template <class LowerLayer>
 void EventWorker<LowerLayer>::emitEvent(EventWorker::EventT event)
 {
-    asio::post(m_ioService, [ this, event = std::move(event) ]() mutable {
+    asio::post(m_strand, [ this, event = std::move(event) ]() mutable {
         LowerLayer::process(std::make_unique<EventT>(std::move(event)));
     });
 }
 
+template <class LowerLayer>
+void EventWorker<LowerLayer>::emitEvent(EventWorker::EventPtr event)
+{
+    asio::post(m_strand, [ this, event = std::move(event) ]() mutable {
+        LowerLayer::process(std::move(event));
+    });
+}
+
 template <class LowerLayer>
 void EventWorker<LowerLayer>::subscribe(Subscription &&subscription)
 {
-    asio::post(m_ioService,
+    asio::post(m_strand,
         [ this, subscription = std::move(subscription) ]() mutable {
             auto id = subscription.id();
             auto handler = LowerLayer::subscribe(
                 std::make_unique<Subscription>(std::move(subscription)));
             m_registry->addUnsubscribeHandler(
                 id, [ this, handler = std::move(handler) ]() mutable {
-                    asio::post(m_ioService, std::move(handler));
+                    asio::post(m_strand, std::move(handler));
                 });
         });
 }
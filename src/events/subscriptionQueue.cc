@@ -0,0 +1,69 @@
+/**
+ * @file subscriptionQueue.cc
+ * @author Krzysztof Trzepla
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "subscriptionQueue.h"
+
+namespace one {
+namespace client {
+namespace events {
+
+SubscriptionQueue::SubscriptionQueue(SendSubscription sendSubscription,
+    SendCancellation sendCancellation, bool deferred)
+    : m_sendSubscription{std::move(sendSubscription)}
+    , m_sendCancellation{std::move(sendCancellation)}
+    , m_deferred{deferred}
+{
+}
+
+void SubscriptionQueue::add(const std::string &fileUuid)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    if (m_queuedCancellations.erase(fileUuid) ||
+        m_subscriptions.count(fileUuid))
+        return;
+
+    m_subscriptions.emplace(fileUuid, m_sendSubscription(fileUuid));
+}
+
+void SubscriptionQueue::remove(const std::string &fileUuid)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    auto it = m_subscriptions.find(fileUuid);
+    if (it == m_subscriptions.end())
+        return;
+
+    if (m_deferred)
+        m_queuedCancellations.emplace(fileUuid);
+    else {
+        m_sendCancellation(it->second);
+        m_subscriptions.erase(it);
+    }
+}
+
+void SubscriptionQueue::flush()
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    for (const auto &fileUuid : m_queuedCancellations) {
+        auto it = m_subscriptions.find(fileUuid);
+        m_sendCancellation(it->second);
+        m_subscriptions.erase(it);
+    }
+
+    m_queuedCancellations.clear();
+}
+
+std::size_t SubscriptionQueue::pending() const
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    return m_queuedCancellations.size();
+}
+
+} // namespace events
+} // namespace client
+} // namespace one
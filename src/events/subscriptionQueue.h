@@ -0,0 +1,85 @@
+/**
+ * @file subscriptionQueue.h
+ * @author Krzysztof Trzepla
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#ifndef ONECLIENT_EVENTS_SUBSCRIPTION_QUEUE_H
+#define ONECLIENT_EVENTS_SUBSCRIPTION_QUEUE_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace one {
+namespace client {
+namespace events {
+
+/**
+ * @c SubscriptionQueue keeps per file subscriptions of a single type.
+ * Subscriptions are always sent immediately, so that no remote change is
+ * missed. In deferred mode cancellations are queued and sent only on
+ * @c flush(). A subscription of a file whose cancellation is queued cancels
+ * out with it, so that files released and subscribed again between flushes
+ * generate no messages.
+ */
+class SubscriptionQueue {
+public:
+    using SendSubscription = std::function<std::int64_t(const std::string &)>;
+    using SendCancellation = std::function<void(std::int64_t)>;
+
+    /**
+     * Constructor.
+     * @param sendSubscription Function sending a subscription of a file and
+     * returning its ID.
+     * @param sendCancellation Function sending a cancellation of a
+     * subscription with given ID.
+     * @param deferred Whether cancellations should be queued until @c flush()
+     * instead of being sent immediately.
+     */
+    SubscriptionQueue(SendSubscription sendSubscription,
+        SendCancellation sendCancellation, bool deferred);
+
+    /**
+     * Adds a subscription of a file, unless it is already subscribed. A queued
+     * cancellation of the subscription is dropped instead.
+     * @param fileUuid UUID of file for which subscription is added.
+     */
+    void add(const std::string &fileUuid);
+
+    /**
+     * Removes a subscription of a file, if the file is subscribed.
+     * @param fileUuid UUID of file for which subscription is removed.
+     */
+    void remove(const std::string &fileUuid);
+
+    /**
+     * Sends queued cancellations.
+     */
+    void flush();
+
+    /**
+     * @return Number of queued cancellations.
+     */
+    std::size_t pending() const;
+
+private:
+    SendSubscription m_sendSubscription;
+    SendCancellation m_sendCancellation;
+    const bool m_deferred;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, std::int64_t> m_subscriptions;
+    std::unordered_set<std::string> m_queuedCancellations;
+};
+
+} // namespace events
+} // namespace client
+} // namespace one
+
+#endif // ONECLIENT_EVENTS_SUBSCRIPTION_QUEUE_H
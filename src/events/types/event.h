@@ -33,6 +33,23 @@ public:
      */
     std::size_t counter() const { return m_counter; }
 
+    /**
+     * @return true if the event should not be aggregated any further and
+     * should be emitted as soon as possible.
+     */
+    virtual bool full() const { return false; }
+
+    /**
+     * @return Estimated size of memory taken by the event in bytes.
+     */
+    virtual std::size_t footprint() const { return sizeof(Event); }
+
+    /**
+     * Aggregates the event harder, reducing its footprint at the cost of
+     * precision. Called for events which cannot be sent for a while.
+     */
+    virtual void collapse() {}
+
     /**
      * @return @c Event in string format.
      */
@@ -45,6 +45,11 @@ void FileAccessedEvent::aggregate(EventPtr event)
     m_releaseCount += event->m_releaseCount;
 }
 
+std::size_t FileAccessedEvent::footprint() const
+{
+    return sizeof(FileAccessedEvent) + m_fileUuid.capacity();
+}
+
 std::string FileAccessedEvent::toString() const
 {
     std::stringstream stream;
@@ -78,6 +78,8 @@ public:
      */
     void aggregate(EventPtr event);
 
+    std::size_t footprint() const override;
+
     std::string toString() const override;
 
     std::unique_ptr<ProtocolEventMessage> serializeAndDestroy() override;
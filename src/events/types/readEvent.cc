@@ -10,7 +10,10 @@
 
 #include "messages.pb.h"
 
+#include <iterator>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 namespace one {
 namespace client {
@@ -41,6 +44,45 @@ void ReadEvent::aggregate(EventPtr event)
     m_blocks += event->m_blocks;
 }
 
+void ReadEvent::aggregate(off_t offset_, std::size_t size_)
+{
+    ++m_counter;
+    m_size += size_;
+    m_blocks += std::make_pair(
+        boost::icl::discrete_interval<off_t>::right_open(
+            offset_, offset_ + size_),
+        FileBlock{});
+}
+
+std::size_t ReadEvent::footprint() const
+{
+    // Each block takes a map node with an interval, a file block and links
+    return sizeof(ReadEvent) + m_fileUuid.capacity() +
+        m_blocks.iterative_size() *
+        (sizeof(FileBlocksMap::value_type) + 4 * sizeof(void *));
+}
+
+void ReadEvent::collapse()
+{
+    if (m_blocks.empty())
+        return;
+
+    std::vector<std::pair<boost::icl::discrete_interval<off_t>, FileBlock>>
+        gaps;
+
+    for (auto it = m_blocks.begin(), next = std::next(it);
+         next != m_blocks.end(); it = next++)
+        if (it->second == next->second)
+            gaps.emplace_back(
+                boost::icl::discrete_interval<off_t>::right_open(
+                    it->first.upper(), next->first.lower()),
+                it->second);
+
+    // Adjacent blocks of the same storage file are joined by the map.
+    for (auto &gap : gaps)
+        m_blocks += std::move(gap);
+}
+
 std::string ReadEvent::toString() const
 {
     std::stringstream stream;
@@ -56,6 +98,7 @@ std::unique_ptr<ProtocolEventMessage> ReadEvent::serializeAndDestroy()
     eventMsg->set_counter(m_counter);
     readEventMsg->mutable_file_uuid()->swap(m_fileUuid);
     readEventMsg->set_size(m_size);
+    readEventMsg->mutable_blocks()->Reserve(m_blocks.iterative_size());
     for (auto &block : m_blocks) {
         auto blockMsg = readEventMsg->add_blocks();
         blockMsg->set_offset(block.first.lower());
@@ -82,6 +82,22 @@ public:
      */
     void aggregate(EventPtr event);
 
+    /**
+     * Aggregates @c this event with a read operation in place.
+     * @param offset Distance from the beginning of the file to the first byte
+     * read.
+     * @param size Number of bytes read.
+     */
+    void aggregate(off_t offset, std::size_t size);
+
+    std::size_t footprint() const override;
+
+    /**
+     * Merges read blocks of the same storage file into a single block
+     * spanning all of them.
+     */
+    void collapse() override;
+
     std::string toString() const override;
 
     std::unique_ptr<ProtocolEventMessage> serializeAndDestroy() override;
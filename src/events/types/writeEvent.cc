@@ -12,12 +12,26 @@
 
 #include <boost/optional/optional_io.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 namespace one {
 namespace client {
 namespace events {
 
+namespace {
+const WriteEvent::FragmentationLimitsPtr &defaultLimits()
+{
+    static const WriteEvent::FragmentationLimitsPtr limits =
+        std::make_shared<WriteEvent::FragmentationLimits>();
+    return limits;
+}
+}
+
 WriteEvent::WriteEvent(off_t offset_, std::size_t size_, std::string fileUuid_,
     std::string storageId_, std::string fileId_)
     : m_fileUuid{std::move(fileUuid_)}
@@ -25,6 +39,7 @@ WriteEvent::WriteEvent(off_t offset_, std::size_t size_, std::string fileUuid_,
     , m_blocks{{boost::icl::discrete_interval<off_t>::right_open(
                     offset_, offset_ + size_),
           FileBlock{std::move(storageId_), std::move(fileId_)}}}
+    , m_limits{defaultLimits()}
 {
 }
 
@@ -36,6 +51,16 @@ WriteEvent::WriteEvent(off_t offset_, std::size_t size_, off_t fileSize_,
     , m_blocks{{boost::icl::discrete_interval<off_t>::right_open(
                     offset_, offset_ + size_),
           FileBlock{std::move(storageId_), std::move(fileId_)}}}
+    , m_limits{defaultLimits()}
+{
+}
+
+WriteEvent::WriteEvent(
+    std::size_t size_, std::string fileUuid_, FileBlocksMap blocks_)
+    : m_fileUuid{std::move(fileUuid_)}
+    , m_size{size_}
+    , m_blocks{std::move(blocks_)}
+    , m_limits{defaultLimits()}
 {
 }
 
@@ -54,13 +79,92 @@ void WriteEvent::aggregate(EventPtr event)
     m_counter += event->m_counter;
     m_size += event->m_size;
 
-    if (event->m_fileSize)
+    if (event->m_fileSize) {
         m_fileSize = std::move(event->m_fileSize);
-    else if (m_fileSize &&
-        m_fileSize.get() < boost::icl::last(event->m_blocks) + 1)
-        m_fileSize = boost::icl::last(event->m_blocks) + 1;
+        m_blocks += event->m_blocks;
+        coalesce();
+    }
+    else
+        addBlocks(event->m_blocks);
+}
 
-    m_blocks += event->m_blocks;
+void WriteEvent::aggregate(std::size_t size_, const FileBlocksMap &blocks_)
+{
+    ++m_counter;
+    m_size += size_;
+    addBlocks(blocks_);
+}
+
+void WriteEvent::addBlocks(const FileBlocksMap &blocks_)
+{
+    if (m_fileSize && !blocks_.empty() &&
+        m_fileSize.get() < boost::icl::last(blocks_) + 1)
+        m_fileSize = boost::icl::last(blocks_) + 1;
+
+    m_blocks += blocks_;
+    coalesce();
+}
+
+bool WriteEvent::full() const
+{
+    return m_blocks.iterative_size() >= m_limits->maxBlocks;
+}
+
+void WriteEvent::setFragmentationLimits(FragmentationLimitsPtr limits)
+{
+    m_limits = std::move(limits);
+}
+
+void WriteEvent::coalesce()
+{
+    if (m_blocks.iterative_size() <=
+        std::max(m_limits->coalesceBlocks, 2 * m_coalescedBlocks))
+        return;
+
+    const auto coalesceGap = static_cast<off_t>(m_limits->coalesceGap);
+    if (coalesceGap == 0)
+        return;
+
+    fillGaps(coalesceGap);
+    m_coalescedBlocks = m_blocks.iterative_size();
+}
+
+void WriteEvent::collapse()
+{
+    fillGaps(std::numeric_limits<off_t>::max());
+    m_coalescedBlocks = m_blocks.iterative_size();
+}
+
+void WriteEvent::fillGaps(const off_t maxGap)
+{
+    if (m_blocks.empty())
+        return;
+
+    std::vector<std::pair<boost::icl::discrete_interval<off_t>, FileBlock>>
+        gaps;
+
+    for (auto it = m_blocks.begin(), next = std::next(it);
+         next != m_blocks.end(); it = next++) {
+        const auto gapStart = it->first.upper();
+        const auto gapEnd = next->first.lower();
+        if (gapEnd - gapStart <= maxGap && it->second == next->second)
+            gaps.emplace_back(
+                boost::icl::discrete_interval<off_t>::right_open(
+                    gapStart, gapEnd),
+                it->second);
+    }
+
+    // Adjacent blocks of the same storage file are joined by the map.
+    for (auto &gap : gaps)
+        m_blocks += std::move(gap);
+}
+
+std::size_t WriteEvent::footprint() const
+{
+    // Each block takes a map node with an interval, a file block and links
+    return sizeof(WriteEvent) + m_fileUuid.capacity() +
+        m_blocks.iterative_size() *
+        (sizeof(FileBlocksMap::value_type) + 4 * sizeof(void *));
 }
 
 std::string WriteEvent::toString() const
@@ -81,17 +185,23 @@ std::unique_ptr<ProtocolEventMessage> WriteEvent::serializeAndDestroy()
     writeEventMsg->mutable_file_uuid()->swap(m_fileUuid);
     writeEventMsg->set_size(m_size);
 
-    auto blocks_ = m_blocks;
-    if (m_fileSize) {
+    if (m_fileSize)
         writeEventMsg->set_file_size(m_fileSize.get());
-        blocks_ &= boost::icl::discrete_interval<off_t>::right_open(
-            0, m_fileSize.get());
-    }
 
-    for (auto &block : blocks_) {
+    // Blocks are serialized straight from the map, cut at the file size.
+    writeEventMsg->mutable_blocks()->Reserve(m_blocks.iterative_size());
+    for (auto &block : m_blocks) {
+        auto upper = block.first.upper();
+        if (m_fileSize) {
+            if (block.first.lower() >= m_fileSize.get())
+                break;
+
+            upper = std::min(upper, m_fileSize.get());
+        }
+
         auto blockMsg = writeEventMsg->add_blocks();
         blockMsg->set_offset(block.first.lower());
-        blockMsg->set_size(boost::icl::size(block.first));
+        blockMsg->set_size(upper - block.first.lower());
         blockMsg->mutable_storage_id()->swap(block.second.mutableStorageId());
         blockMsg->mutable_file_id()->swap(block.second.mutableFileId());
     }
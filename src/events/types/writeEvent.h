@@ -38,6 +38,19 @@ public:
         boost::icl::partial_enricher>;
     using Subscription = WriteSubscription;
 
+    /**
+     * @c FragmentationLimits bound the number of blocks of a write event.
+     */
+    struct FragmentationLimits {
+        /// Number of write blocks after which a write event should be emitted
+        std::size_t maxBlocks = 4096;
+        /// Number of write blocks after which nearby blocks are merged
+        std::size_t coalesceBlocks = 1024;
+        /// Maximal size of a gap between merged blocks; 0 disables merging
+        std::size_t coalesceGap = 0;
+    };
+    using FragmentationLimitsPtr = std::shared_ptr<const FragmentationLimits>;
+
     /**
      * Constructor.
      * @param offset Distance from the beginning of the file to the first byte
@@ -67,6 +80,15 @@ public:
         std::string fileUuid, std::string storageId = {},
         std::string fileId = {});
 
+    /**
+     * Constructor.
+     * @param size Number of bytes written.
+     * @param fileUuid UUID of a file associated with a write operation.
+     * @param blocks Written ranges mapped to storage IDs and file IDs where
+     * the write operation occurred.
+     */
+    WriteEvent(std::size_t size, std::string fileUuid, FileBlocksMap blocks);
+
     /**
      * @return Value that distinguish @c this write event from other write
      * events, i.e. write events with the same key can be aggregated.
@@ -101,10 +123,44 @@ public:
      * - addition of events' sizes
      * - union of sets of write blocks
      * - substitution of file size with file size associated with other event
+     * If the number of write blocks exceeds the coalescing threshold, blocks
+     * of the same storage file separated by gaps not larger than the
+     * coalescing gap are merged.
      * @param event Write event to be aggregated.
      */
     void aggregate(EventPtr event);
 
+    /**
+     * Aggregates @c this event with a write operation in place.
+     * @param size Number of bytes written.
+     * @param blocks Written ranges mapped to storage IDs and file IDs where
+     * the write operation occurred.
+     * @see WriteEvent::aggregate(EventPtr)
+     */
+    void aggregate(std::size_t size, const FileBlocksMap &blocks);
+
+    /**
+     * @return true if the number of write blocks has reached the maximal
+     * number of blocks of a write event.
+     */
+    bool full() const override;
+
+    /**
+     * Sets limits of write blocks fragmentation of @c this event, applied
+     * also to events aggregated into it. Default limits are used otherwise.
+     * @param limits Limits to be set.
+     */
+    void setFragmentationLimits(FragmentationLimitsPtr limits);
+
+    std::size_t footprint() const override;
+
+    /**
+     * Merges write blocks of the same storage file into a single block
+     * spanning all of them, so that ranges between them are reported as
+     * written as well.
+     */
+    void collapse() override;
+
     std::string toString() const override;
 
     std::unique_ptr<ProtocolEventMessage> serializeAndDestroy() override;
@@ -114,6 +170,14 @@ protected:
     std::size_t m_size = 0;
     boost::optional<off_t> m_fileSize;
     FileBlocksMap m_blocks;
+
+private:
+    void addBlocks(const FileBlocksMap &blocks);
+    void coalesce();
+    void fillGaps(off_t maxGap);
+
+    std::size_t m_coalescedBlocks = 0;
+    FragmentationLimitsPtr m_limits;
 };
 
 } // namespace events
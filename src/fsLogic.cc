@@ -14,6 +14,7 @@
 #include "helpers/IStorageHelper.h"
 #include "logging.h"
 #include "options.h"
+#include "utils.hpp"
 
 #include "messages/configuration.h"
 #include "messages/fuse/changeMode.h"
@@ -30,16 +31,25 @@
 #include "messages/fuse/helperParams.h"
 #include "messages/fuse/release.h"
 #include "messages/fuse/rename.h"
+#include "messages/fuse/synchronizeBlock.h"
 #include "messages/fuse/synchronizeBlockAndComputeChecksum.h"
 #include "messages/fuse/truncate.h"
 #include "messages/fuse/updateTimes.h"
 
 #include <boost/algorithm/string.hpp>
+#include <boost/icl/interval_set.hpp>
 #include <openssl/md4.h>
 
 #include <sys/stat.h>
 
+#include <asio/post.hpp>
+
 #include <algorithm>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <future>
+#include <limits>
 #include <memory>
 #include <random>
 
@@ -49,6 +59,33 @@ namespace one {
 namespace client {
 
 namespace {
+/// Number of children fetched with a single @c GetFileChildren request.
+constexpr std::size_t DIR_PAGE_SIZE = 1000;
+
+/// Number of @c GetFileChildren requests kept in flight while listing a
+/// large directory.
+constexpr std::size_t DIR_PAGES_IN_FLIGHT = 4;
+
+/// Number of recently listed directories remembered for attribute prefetch.
+constexpr std::size_t LISTED_DIRECTORIES_LIMIT = 16;
+
+/// Number of @c GetFileAttr requests kept in flight while prefetching
+/// attributes of listed files.
+constexpr std::size_t PREFETCH_ATTRS_IN_FLIGHT = 64;
+
+/// Number of cache expiration ticks after which prefetched attributes of a
+/// file that has not been looked up are dropped. Such files are not
+/// subscribed for changes, so their attributes are kept only briefly.
+constexpr std::size_t PREFETCHED_ATTRS_TTL = 5;
+
+/// Number of ranges written through a file handle that are published to
+/// the metadata cache at once.
+constexpr std::size_t WRITE_ACCUMULATOR_MAX_RANGES = 64;
+
+/// Number of cache expiration ticks between saves of the directory cache
+/// file.
+constexpr std::size_t DIRECTORY_CACHE_SAVE_TICKS = 60;
+
 unsigned long getfsid()
 {
     std::random_device device;
@@ -56,6 +93,34 @@ unsigned long getfsid()
     std::uniform_int_distribution<unsigned long> distribution{1};
     return distribution(engine);
 }
+
+void fillStat(
+    const messages::fuse::FileAttr &attr, struct stat *const statbuf)
+{
+    statbuf->st_atime = std::chrono::system_clock::to_time_t(attr.atime());
+    statbuf->st_mtime = std::chrono::system_clock::to_time_t(attr.mtime());
+    statbuf->st_ctime = std::chrono::system_clock::to_time_t(attr.ctime());
+    statbuf->st_gid = attr.gid();
+    statbuf->st_uid = attr.uid();
+    statbuf->st_mode = attr.mode();
+    statbuf->st_size = attr.size().get();
+    statbuf->st_nlink = 1;
+    statbuf->st_blocks = 0;
+
+    switch (attr.type()) {
+        case messages::fuse::FileAttr::FileType::directory:
+            statbuf->st_mode |= S_IFDIR;
+            // Remove sticky bit for nfs compatibility
+            statbuf->st_mode &= ~S_ISVTX;
+            break;
+        case messages::fuse::FileAttr::FileType::link:
+            statbuf->st_mode |= S_IFLNK;
+            break;
+        case messages::fuse::FileAttr::FileType::regular:
+            statbuf->st_mode |= S_IFREG;
+            break;
+    }
+}
 }
 
 FsLogic::FsLogic(std::shared_ptr<Context> context,
@@ -66,8 +131,12 @@ FsLogic::FsLogic(std::shared_ptr<Context> context,
     , m_context{std::move(context)}
     , m_eventManager{m_context}
     , m_helpersCache{*m_context->communicator(), *m_context->scheduler()}
-    , m_metadataCache{*m_context->communicator()}
-    , m_fsSubscriptions{m_eventManager}
+    , m_metadataCache{*m_context->communicator(),
+          m_context->options()->get_negative_cache_max_entries()}
+    , m_directoryCache{m_context->options()->get_dir_cache_max_entries()}
+    , m_fsSubscriptions{m_eventManager, m_context->scheduler(),
+          std::chrono::milliseconds{
+              m_context->options()->get_subscriptions_flush_interval()}}
     , m_forceProxyIOCache{m_fsSubscriptions}
 {
     m_eventManager.setFileAttrHandler(fileAttrHandler());
@@ -82,30 +151,124 @@ FsLogic::FsLogic(std::shared_ptr<Context> context,
     m_fsSubscriptions.addQuotaSubscription();
     disableSpaces(configuration->disabledSpacesContainer());
 
+    loadDirectoryCache();
     scheduleCacheExpirationTick();
+
+    const auto ioThreadsNo =
+        std::max(m_context->options()->get_io_threads(), 1u);
+    for (unsigned int i = 0; i < ioThreadsNo; ++i)
+        m_ioThreads.emplace_back([this] {
+            etls::utils::nameThread("FsLogicIO");
+            m_ioService.run();
+        });
+
+    m_prefetchThread = std::thread{[this] {
+        etls::utils::nameThread("FsLogicPrefetch");
+        m_prefetchService.run();
+    }};
 }
 
 FsLogic::~FsLogic()
 {
-    std::lock_guard<std::mutex> guard{m_cancelCacheExpirationTickMutex};
-    m_cancelCacheExpirationTick();
+    {
+        std::lock_guard<std::mutex> guard{m_cancelCacheExpirationTickMutex};
+        m_cancelCacheExpirationTick();
+    }
+
+    m_prefetchService.stop();
+    m_prefetchThread.join();
+
+    m_ioService.stop();
+    for (auto &thread : m_ioThreads)
+        thread.join();
+
+    saveDirectoryCache();
+}
+
+void FsLogic::loadDirectoryCache()
+{
+    if (!m_context->options()->has_metadata_cache_file())
+        return;
+
+    const auto file = m_context->options()->get_metadata_cache_file();
+    try {
+        auto loaded = m_directoryCache.load(file);
+        LOG(INFO) << "Loaded " << loaded << " directory listings from "
+                  << file;
+    }
+    catch (const std::system_error &e) {
+        LOG(WARNING) << "Cannot load directory listings from " << file
+                     << ": " << e.what();
+    }
+}
+
+void FsLogic::saveDirectoryCache()
+{
+    if (!m_context->options()->has_metadata_cache_file())
+        return;
+
+    const auto file = m_context->options()->get_metadata_cache_file();
+    try {
+        m_directoryCache.save(file);
+    }
+    catch (const std::system_error &e) {
+        LOG(WARNING) << "Cannot save directory listings to " << file << ": "
+                     << e.what();
+    }
 }
 
 void FsLogic::scheduleCacheExpirationTick()
 {
     std::lock_guard<std::mutex> guard{m_cancelCacheExpirationTickMutex};
     m_cancelCacheExpirationTick = m_context->scheduler()->schedule(1s, [this] {
-        m_locExpirationHelper.tick([this](const std::string &uuid) {
+        m_metadataCache.expireMissingPaths();
+
+        auto purgeLocation = [this](const std::string &uuid) {
             m_metadataCache.remove(uuid);
             m_fsSubscriptions.removeFileLocationSubscription(uuid);
-        });
+        };
 
-        m_attrExpirationHelper.tick([this](const std::string &uuid) {
+        // Listings of directories no longer subscribed for changes are kept
+        // aside until they can be checked against a fresh attribute
+        auto purgeAttr = [this](const std::string &uuid) {
             m_metadataCache.remove(uuid);
+            m_directoryCache.retire(uuid);
             m_fsSubscriptions.removeFileAttrSubscription(uuid);
             m_fsSubscriptions.removeFileRemovalSubscription(uuid);
             m_fsSubscriptions.removeFileRenamedSubscription(uuid);
-        });
+        };
+
+        // Metadata of listed files is kept only as long as it is not used
+        // otherwise
+        auto purgeListed = [this](const std::string &uuid) {
+            if (!m_attrExpirationHelper.tracked(uuid) &&
+                !m_locExpirationHelper.tracked(uuid))
+                m_metadataCache.remove(uuid);
+        };
+
+        m_locExpirationHelper.tick(purgeLocation);
+        m_attrExpirationHelper.tick(purgeAttr);
+        m_listingExpirationHelper.tick(purgeListed);
+
+        // Metadata of open files and files known to the kernel is pinned, so
+        // the cache may stay over its limit if there are enough of them
+        const auto maxEntries =
+            m_context->options()->get_metadata_cache_max_entries();
+        const auto maxSize =
+            m_context->options()->get_metadata_cache_max_size();
+        auto overLimit = [&] {
+            return (maxEntries > 0 && m_metadataCache.size() > maxEntries) ||
+                (maxSize > 0 && m_metadataCache.footprint() > maxSize);
+        };
+
+        m_listingExpirationHelper.evict(purgeListed, overLimit);
+        m_attrExpirationHelper.evict(purgeAttr, overLimit);
+        m_locExpirationHelper.evict(purgeLocation, overLimit);
+
+        // The cache file is written and synced on the prefetch thread, so
+        // that the tick does not wait for the disk
+        if (++m_cacheExpirationTicks % DIRECTORY_CACHE_SAVE_TICKS == 0)
+            asio::post(m_prefetchService, [this] { saveDirectoryCache(); });
 
         scheduleCacheExpirationTick();
     });
@@ -122,30 +285,10 @@ int FsLogic::getattr(boost::filesystem::path path, struct stat *const statbuf)
     DLOG(INFO) << "FUSE: getattr(path: " << path << ", ...)";
 
     auto attr = m_metadataCache.getAttr(path);
+    if (publishWrites(attr.uuid()))
+        attr = m_metadataCache.getAttr(attr.uuid());
 
-    statbuf->st_atime = std::chrono::system_clock::to_time_t(attr.atime());
-    statbuf->st_mtime = std::chrono::system_clock::to_time_t(attr.mtime());
-    statbuf->st_ctime = std::chrono::system_clock::to_time_t(attr.ctime());
-    statbuf->st_gid = attr.gid();
-    statbuf->st_uid = attr.uid();
-    statbuf->st_mode = attr.mode();
-    statbuf->st_size = attr.size().get();
-    statbuf->st_nlink = 1;
-    statbuf->st_blocks = 0;
-
-    switch (attr.type()) {
-        case messages::fuse::FileAttr::FileType::directory:
-            statbuf->st_mode |= S_IFDIR;
-            // Remove sticky bit for nfs compatibility
-            statbuf->st_mode &= ~S_ISVTX;
-            break;
-        case messages::fuse::FileAttr::FileType::link:
-            statbuf->st_mode |= S_IFLNK;
-            break;
-        case messages::fuse::FileAttr::FileType::regular:
-            statbuf->st_mode |= S_IFREG;
-            break;
-    }
+    fillStat(attr, statbuf);
 
     m_attrExpirationHelper.markInteresting(attr.uuid(), [&] {
         m_metadataCache.getAttr(attr.uuid());
@@ -154,6 +297,13 @@ int FsLogic::getattr(boost::filesystem::path path, struct stat *const statbuf)
         m_fsSubscriptions.addFileRenamedSubscription(attr.uuid());
     });
 
+    // Resolving the parent is skipped while no listing awaits prefetch
+    if (m_pendingListedDirectories > 0) {
+        auto parentUuid = m_metadataCache.getUuid(path.parent_path());
+        if (parentUuid)
+            statAhead(parentUuid.get());
+    }
+
     return 0;
 }
 
@@ -193,6 +343,10 @@ int FsLogic::mkdir(boost::filesystem::path path, const mode_t mode)
 
     communication::wait(future);
 
+    // Uuid of the new directory is not known until it is looked up
+    m_directoryCache.invalidate(parentAttr.uuid());
+    m_metadataCache.forgetMissing(path);
+
     return 0;
 }
 
@@ -226,7 +380,11 @@ int FsLogic::rename(
                << ", newpath: " << newPath << "')";
 
     auto uuidChanges = m_metadataCache.rename(oldPath, newPath);
+    updateListings(oldPath, newPath);
+
     for (auto &uuidChange : uuidChanges) {
+        m_directoryCache.invalidate(uuidChange.first);
+        m_inodeCache.rename(uuidChange.first, uuidChange.second);
         m_attrExpirationHelper.rename(uuidChange.first, uuidChange.second, [&] {
             m_fsSubscriptions.removeFileAttrSubscription(uuidChange.first);
             m_fsSubscriptions.removeFileRemovalSubscription(uuidChange.first);
@@ -236,6 +394,8 @@ int FsLogic::rename(
             m_fsSubscriptions.addFileRemovalSubscription(uuidChange.second);
             m_fsSubscriptions.addFileRenamedSubscription(uuidChange.second);
         });
+        m_listingExpirationHelper.rename(
+            uuidChange.first, uuidChange.second, [] {});
     }
 
     return 0;
@@ -246,20 +406,24 @@ int FsLogic::chmod(boost::filesystem::path path, const mode_t mode)
     DLOG(INFO) << "FUSE: chmod(path: " << path << ", mode: " << std::oct << mode
                << ")";
 
+    auto attr = m_metadataCache.getAttr(path);
+    changeMode(attr.uuid(), mode);
+    return 0;
+}
+
+void FsLogic::changeMode(const std::string &uuid, const mode_t mode)
+{
     const mode_t normalizedMode = mode & ALLPERMS;
 
-    MetadataCache::UuidAccessor uuidAcc;
     MetadataCache::MetaAccessor metaAcc;
-    m_metadataCache.getAttr(uuidAcc, metaAcc, path);
+    m_metadataCache.getAttr(metaAcc, uuid);
 
     auto future =
         m_context->communicator()->communicate<messages::fuse::FuseResponse>(
-            messages::fuse::ChangeMode{uuidAcc->second, normalizedMode});
+            messages::fuse::ChangeMode{uuid, normalizedMode});
 
     communication::wait(future);
-    metaAcc->second.attr.get().mode(normalizedMode);
-
-    return 0;
+    metaAcc.attr().mode(normalizedMode);
 }
 
 int FsLogic::chown(
@@ -276,9 +440,19 @@ int FsLogic::truncate(boost::filesystem::path path, const off_t newSize)
     DLOG(INFO) << "FUSE: truncate(path: " << path << ", newSize: " << newSize
                << ")";
 
+    auto attr = m_metadataCache.getAttr(path);
+    truncateFile(attr.uuid(), newSize);
+    return 0;
+}
+
+void FsLogic::truncateFile(const std::string &uuid, const off_t newSize)
+{
+    // Pending blocks must not extend the file again after it is truncated
+    publishWrites(uuid);
+
     MetadataCache::MetaAccessor acc;
-    m_metadataCache.getAttr(acc, path);
-    auto &attr = acc->second.attr.get();
+    m_metadataCache.getAttr(acc, uuid);
+    auto &attr = acc.attr();
 
     auto future =
         m_context->communicator()->communicate<messages::fuse::FuseResponse>(
@@ -289,31 +463,31 @@ int FsLogic::truncate(boost::filesystem::path path, const off_t newSize)
     auto flagsSet = one::helpers::FlagsSet{one::helpers::Flag::WRONLY};
     m_metadataCache.getLocation(acc, attr.uuid(), flagsSet);
     acc->second.locations.at(MetadataCache::filterFlagsForLocation(flagsSet))
-        .blocks() &=
-        boost::icl::discrete_interval<off_t>::right_open(0, newSize);
+        .truncateBlocks(newSize);
 
     m_eventManager.emitTruncateEvent(newSize, attr.uuid());
-
-    return 0;
 }
 
 int FsLogic::utime(boost::filesystem::path path, struct utimbuf *const ubuf)
 {
     DLOG(INFO) << "FUSE: utime(path: " << path << ", ...)";
 
-    MetadataCache::UuidAccessor uuidAcc;
+    auto attr = m_metadataCache.getAttr(path);
+    updateTimes(attr.uuid(), ubuf->actime, ubuf->modtime);
+    return 0;
+}
+
+void FsLogic::updateTimes(
+    const std::string &uuid, const std::time_t atime, const std::time_t mtime)
+{
     MetadataCache::MetaAccessor metaAcc;
-    m_metadataCache.getAttr(uuidAcc, metaAcc, path);
+    m_metadataCache.getAttr(metaAcc, uuid);
 
-    messages::fuse::UpdateTimes msg{uuidAcc->second};
+    messages::fuse::UpdateTimes msg{uuid};
 
     const auto now = std::chrono::system_clock::now();
-    msg.atime(ubuf->actime
-            ? std::chrono::system_clock::from_time_t(ubuf->actime)
-            : now);
-    msg.mtime(ubuf->modtime
-            ? std::chrono::system_clock::from_time_t(ubuf->modtime)
-            : now);
+    msg.atime(atime ? std::chrono::system_clock::from_time_t(atime) : now);
+    msg.mtime(mtime ? std::chrono::system_clock::from_time_t(mtime) : now);
     msg.ctime(now);
 
     auto future =
@@ -322,12 +496,10 @@ int FsLogic::utime(boost::filesystem::path path, struct utimbuf *const ubuf)
 
     communication::wait(future);
 
-    auto &attr = metaAcc->second.attr.get();
+    auto &attr = metaAcc.attr();
     attr.atime(msg.atime().get());
     attr.mtime(msg.mtime().get());
     attr.mtime(msg.ctime().get());
-
-    return 0;
 }
 
 int FsLogic::open(
@@ -382,6 +554,55 @@ helpers::CTXPtr getHelperCtx(FileContextCache::FileContext &fileCtx,
     return ctxAcc->second;
 }
 
+/**
+ * Calls @p fun on every element of @p parts concurrently. The first element
+ * is processed on the calling thread and the rest on @p ioService workers.
+ * Returns once all calls have finished, rethrowing the first exception.
+ * @return Results of the calls, in order of @p parts.
+ */
+template <typename Part, typename Fun>
+auto forEachConcurrently(
+    asio::io_service &ioService, const std::vector<Part> &parts, Fun &&fun)
+{
+    using Result = decltype(fun(parts.front()));
+
+    std::vector<std::future<Result>> futures;
+    futures.reserve(parts.size());
+    for (std::size_t i = 1; i < parts.size(); ++i) {
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            [&, i] { return fun(parts[i]); });
+
+        futures.emplace_back(task->get_future());
+        asio::post(ioService, [task] { (*task)(); });
+    }
+
+    std::vector<Result> results;
+    results.reserve(parts.size());
+    std::exception_ptr exception;
+
+    try {
+        results.emplace_back(fun(parts.front()));
+    }
+    catch (...) {
+        exception = std::current_exception();
+    }
+
+    for (auto &future : futures) {
+        try {
+            results.emplace_back(future.get());
+        }
+        catch (...) {
+            if (!exception)
+                exception = std::current_exception();
+        }
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+
+    return results;
+}
+
 } // namespace
 
 int FsLogic::read(boost::filesystem::path path, asio::mutable_buffer buf,
@@ -391,7 +612,16 @@ int FsLogic::read(boost::filesystem::path path, asio::mutable_buffer buf,
                << ", bufferSize: " << asio::buffer_size(buf)
                << ", offset: " << offset << ", ...)";
 
+    return readFile(buf, offset, fileInfo);
+}
+
+std::size_t FsLogic::readFile(asio::mutable_buffer buf, const off_t offset,
+    struct fuse_file_info *const fileInfo)
+{
     auto context = m_fileContextCache.get(fileInfo->fh);
+    if (*context.pendingWrites > 0)
+        publishWrites(context.uuid);
+
     auto attr = m_metadataCache.getAttr(context.uuid);
     auto location = m_metadataCache.getLocation(context.uuid,
         one::helpers::IStorageHelper::maskToFlags(fileInfo->flags));
@@ -408,49 +638,101 @@ int FsLogic::read(boost::filesystem::path path, asio::mutable_buffer buf,
     if (boost::icl::size(wantedRange) == 0)
         return 0;
 
-    // Even if several "touching" blocks with different helpers are available to
-    // read right now, for simplicity we'll only read a single block per a read
-    // operation.
-    auto availableBlockIt =
-        location.blocks().find(boost::icl::discrete_interval<off_t>(offset));
-
     boost::optional<messages::fuse::Checksum> serverChecksum;
     auto flagSet = one::helpers::IStorageHelper::maskToFlags(fileInfo->flags);
-    bool dataNeedsSynchronization = availableBlockIt == location.blocks().end();
+    bool dataNeedsSynchronization =
+        location.blocks().find(boost::icl::discrete_interval<off_t>(offset)) ==
+        location.blocks().end();
+
     if (dataNeedsSynchronization) {
+        const auto syncStart = SyncAhead::Clock::now();
         serverChecksum =
             waitForBlockSynchronization(context.uuid, wantedRange, flagSet);
         location = m_metadataCache.getLocation(context.uuid, flagSet);
-        availableBlockIt = location.blocks().find(
-            boost::icl::discrete_interval<off_t>(offset));
+
+        if (context.syncAhead)
+            context.syncAhead->onStall(SyncAhead::Clock::now() - syncStart);
+    }
+
+    // Read every block that contiguously covers the wanted range, starting at
+    // the requested offset
+    struct ReadPart {
+        boost::icl::discrete_interval<off_t> range;
+        messages::fuse::FileBlock fileBlock;
+        HelpersCache::HelperPtr helper;
+        helpers::CTXPtr helperCtx;
+    };
+
+    std::vector<ReadPart> parts;
+    auto nextOffset = offset;
+    for (auto it = location.blocks().find(
+             boost::icl::discrete_interval<off_t>(offset));
+         it != location.blocks().end(); ++it) {
+        auto range = it->first & wantedRange;
+        if (boost::icl::is_empty(range) ||
+            boost::icl::first(range) != nextOffset)
+            break;
+
+        nextOffset = boost::icl::last_next(range);
+        parts.push_back({range, it->second, nullptr, nullptr});
     }
 
-    const messages::fuse::FileBlock &fileBlock = availableBlockIt->second;
-    auto availableRange = availableBlockIt->first & wantedRange;
-    buf = asio::buffer(buf, boost::icl::size(availableRange));
+    if (parts.empty())
+        throw std::errc::resource_unavailable_try_again;
 
-    auto helper = getHelper(context.uuid, fileBlock.storageId());
-    auto helperCtx = getHelperCtx(
-        context, helper, fileBlock.storageId(), fileBlock.fileId());
+    const auto availableRange =
+        boost::icl::discrete_interval<off_t>::right_open(offset, nextOffset);
 
     try {
-        if (dataNeedsSynchronization) {
-            helper->sh_flush(helperCtx, fileBlock.fileId());
+        bool needsConsistencyCheck = false;
+        for (auto &part : parts) {
+            part.helper = getHelper(context.uuid, part.fileBlock.storageId());
+            part.helperCtx = getHelperCtx(context, part.helper,
+                part.fileBlock.storageId(), part.fileBlock.fileId());
+            needsConsistencyCheck |= part.helper->needsDataConsistencyCheck();
         }
 
-        auto readBuffer =
-            helper->sh_read(helperCtx, fileBlock.fileId(), buf, offset);
+        auto bytesReadPerPart = forEachConcurrently(
+            m_ioService, parts, [&](const ReadPart &part) {
+                if (dataNeedsSynchronization)
+                    part.helper->sh_flush(
+                        part.helperCtx, part.fileBlock.fileId());
+
+                auto partBuf = asio::buffer(buf +
+                        (boost::icl::first(part.range) - offset),
+                    boost::icl::size(part.range));
+
+                return asio::buffer_size(part.helper->sh_read(part.helperCtx,
+                    part.fileBlock.fileId(), partBuf,
+                    boost::icl::first(part.range)));
+            });
+
+        // A short read of any part ends the contiguous data read
+        std::size_t bytesRead = 0;
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            bytesRead += bytesReadPerPart[i];
+            if (bytesReadPerPart[i] <
+                static_cast<std::size_t>(boost::icl::size(parts[i].range)))
+                break;
+        }
+
+        if (needsConsistencyCheck && dataNeedsSynchronization &&
+            dataCorrupted(context.uuid, asio::buffer(buf, bytesRead),
+                serverChecksum.get(), availableRange, wantedRange)) {
+            // close the files to get data up to date, they will be opened
+            // again by read function
+            for (auto &part : parts) {
+                part.helper->sh_release(
+                    part.helperCtx, part.fileBlock.fileId());
+                context.helperCtxMap->erase(
+                    {part.fileBlock.storageId(), part.fileBlock.fileId()});
+            }
 
-        if (helper->needsDataConsistencyCheck() && dataNeedsSynchronization &&
-            dataCorrupted(context.uuid, readBuffer, serverChecksum.get(),
-                availableRange, wantedRange)) {
-            helper->sh_release(helperCtx,
-                fileBlock.fileId()); // close the file to get data up to date,
-                                     // it will be opened again by read function
-            return read(path, buf, offset, fileInfo);
+            return readFile(buf, offset, fileInfo);
         }
 
-        const auto bytesRead = asio::buffer_size(readBuffer);
+        requestSyncAhead(context, location, offset, bytesRead,
+            attr.size().get());
         m_eventManager.emitReadEvent(offset, bytesRead, context.uuid);
 
         return bytesRead;
@@ -462,7 +744,7 @@ int FsLogic::read(boost::filesystem::path path, asio::mutable_buffer buf,
             throw;
 
         m_forceProxyIOCache.insert(context.uuid);
-        return read(path, buf, offset, fileInfo);
+        return readFile(buf, offset, fileInfo);
     }
 }
 
@@ -480,6 +762,37 @@ messages::fuse::Checksum FsLogic::waitForBlockSynchronization(
     return checksum;
 }
 
+void FsLogic::requestSyncAhead(const FileContextCache::FileContext &context,
+    const messages::fuse::FileLocation &location, const off_t offset,
+    const std::size_t size, const off_t fileSize)
+{
+    if (!context.syncAhead)
+        return;
+
+    auto range = context.syncAhead->onRead(offset, size, fileSize);
+    if (!range)
+        return;
+
+    boost::icl::interval_set<off_t> missing;
+    missing += range.get();
+
+    auto blocks = location.blocks().equal_range(range.get());
+    for (auto it = blocks.first; it != blocks.second; ++it)
+        missing -= it->first;
+
+    if (missing.empty())
+        return;
+
+    // The data will be available in the location once the provider
+    // announces it, so the response is not waited for
+    const auto toSync = boost::icl::hull(missing);
+    DLOG(INFO) << "Synchronizing " << toSync << " ahead of reader of file '"
+               << context.uuid << "'";
+
+    m_context->communicator()->communicate<messages::fuse::FuseResponse>(
+        messages::fuse::SynchronizeBlock{context.uuid, toSync, true});
+}
+
 messages::fuse::Checksum FsLogic::syncAndFetchChecksum(
     const std::string &uuid, const boost::icl::discrete_interval<off_t> &range)
 {
@@ -497,6 +810,12 @@ int FsLogic::write(boost::filesystem::path path, asio::const_buffer buf,
                << ", bufferSize: " << asio::buffer_size(buf)
                << ", offset: " << offset << ", ...)";
 
+    return writeFile(buf, offset, fileInfo);
+}
+
+std::size_t FsLogic::writeFile(asio::const_buffer buf, const off_t offset,
+    struct fuse_file_info *const fileInfo)
+{
     if (asio::buffer_size(buf) == 0)
         return 0;
 
@@ -509,20 +828,57 @@ int FsLogic::write(boost::filesystem::path path, asio::const_buffer buf,
     {
         std::shared_lock<std::shared_timed_mutex> lock{m_disabledSpacesMutex};
         if (m_disabledSpaces.count(location.spaceId()))
-            return -ENOSPC;
+            throw std::errc::no_space_on_device;
     }
 
-    messages::fuse::FileBlock fileBlock;
-    std::tie(fileBlock, buf) = findWriteLocation(location, offset, buf);
+    // Write every block covered by the buffer; gaps between existing blocks
+    // are written to the file's default storage
+    struct WritePart {
+        boost::icl::discrete_interval<off_t> range;
+        messages::fuse::FileBlock fileBlock;
+        HelpersCache::HelperPtr helper;
+        helpers::CTXPtr helperCtx;
+    };
 
-    auto helper = getHelper(context.uuid, location.storageId());
-    auto helperCtx = getHelperCtx(
-        context, helper, fileBlock.storageId(), fileBlock.fileId());
+    std::vector<WritePart> parts;
+    for (auto &writeLocation :
+        findWriteLocations(location, offset, asio::buffer_size(buf)))
+        parts.push_back({writeLocation.first,
+            std::move(writeLocation.second), nullptr, nullptr});
 
-    size_t bytesWritten = 0;
+    std::size_t bytesWritten = 0;
+    events::WriteEvent::FileBlocksMap writtenBlocks;
     try {
-        bytesWritten =
-            helper->sh_write(helperCtx, fileBlock.fileId(), buf, offset);
+        for (auto &part : parts) {
+            part.helper = getHelper(context.uuid, part.fileBlock.storageId());
+            part.helperCtx = getHelperCtx(context, part.helper,
+                part.fileBlock.storageId(), part.fileBlock.fileId());
+        }
+
+        auto bytesWrittenPerPart = forEachConcurrently(
+            m_ioService, parts, [&](const WritePart &part) {
+                auto partBuf = asio::buffer(
+                    buf + (boost::icl::first(part.range) - offset),
+                    boost::icl::size(part.range));
+
+                return part.helper->sh_write(part.helperCtx,
+                    part.fileBlock.fileId(), partBuf,
+                    boost::icl::first(part.range));
+            });
+
+        // A short write of any part ends the contiguous data written
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            const auto partOffset = boost::icl::first(parts[i].range);
+            writtenBlocks += std::make_pair(
+                boost::icl::discrete_interval<off_t>::right_open(
+                    partOffset, partOffset + bytesWrittenPerPart[i]),
+                parts[i].fileBlock);
+
+            bytesWritten += bytesWrittenPerPart[i];
+            if (bytesWrittenPerPart[i] <
+                static_cast<std::size_t>(boost::icl::size(parts[i].range)))
+                break;
+        }
     }
     catch (const std::system_error &e) {
         if (e.code().value() != EPERM && e.code().value() != EACCES)
@@ -531,60 +887,101 @@ int FsLogic::write(boost::filesystem::path path, asio::const_buffer buf,
             throw;
 
         m_forceProxyIOCache.insert(context.uuid);
-        return write(path, buf, offset, fileInfo);
+        return writeFile(buf, offset, fileInfo);
     }
 
-    m_eventManager.emitWriteEvent(offset, bytesWritten, context.uuid,
-        location.storageId(), fileBlock.fileId());
-
-    MetadataCache::MetaAccessor acc;
-    m_metadataCache.getAttr(acc, context.uuid);
-    acc->second.attr.get().size(std::max(acc->second.attr.get().size().get(),
-        static_cast<off_t>(offset + bytesWritten)));
+    if (bytesWritten == 0)
+        return 0;
 
-    auto writtenRange = boost::icl::discrete_interval<off_t>::right_open(
-        offset, offset + bytesWritten);
+    m_eventManager.emitWriteEvent(bytesWritten, context.uuid, writtenBlocks);
 
-    // Call `getLocation` instead of using existing acc for a corner case
-    // where location has been removed since initial `getLocation` call.
-    auto flagsSet = one::helpers::IStorageHelper::maskToFlags(fileInfo->flags);
-    m_metadataCache.getLocation(acc, context.uuid, flagsSet);
-    acc->second.locations.at(MetadataCache::filterFlagsForLocation(flagsSet))
-        .blocks() += std::make_pair(writtenRange, std::move(fileBlock));
+    // Written blocks are published to the metadata cache in batches, or
+    // earlier when someone needs the file's size or blocks
+    if (context.writeAccumulator &&
+        context.writeAccumulator->add(writtenBlocks))
+        publishWrites(context.uuid, context.writeAccumulator);
 
     return bytesWritten;
 }
 
-std::tuple<messages::fuse::FileBlock, asio::const_buffer>
-FsLogic::findWriteLocation(const messages::fuse::FileLocation &fileLocation,
-    const off_t offset, const asio::const_buffer &buf)
+bool FsLogic::publishWrites(const std::string &uuid)
 {
-    const auto wantedRange = boost::icl::discrete_interval<off_t>::right_open(
-        offset, offset + asio::buffer_size(buf));
+    std::vector<std::shared_ptr<WriteAccumulator>> accumulators;
+    {
+        ConstWriteAccumulatorsAccessor acc;
+        if (!m_writeAccumulators.find(acc, uuid))
+            return false;
+
+        if (*acc->second.pending == 0)
+            return false;
+
+        accumulators = acc->second.accumulators;
+    }
+
+    bool published = false;
+    for (auto &accumulator : accumulators) {
+        published |= !accumulator->empty();
+        publishWrites(uuid, accumulator);
+    }
 
-    // Even if several "touching" blocks with different helpers are
-    // available to write right now, for simplicity we'll only write to a
-    // single block per a write operation.
+    return published;
+}
 
-    boost::icl::discrete_interval<off_t> offsetInterval{offset};
-    auto availableBlockIt = fileLocation.blocks().lower_bound(offsetInterval);
+void FsLogic::publishWrites(const std::string &uuid,
+    const std::shared_ptr<WriteAccumulator> &accumulator)
+{
+    if (!accumulator)
+        return;
+
+    accumulator->flush([&](const WriteAccumulator::FileBlocksMap &blocks,
+        const off_t end) {
+        MetadataCache::MetaAccessor acc;
+        m_metadataCache.getAttr(acc, uuid);
+        auto &attr = acc.attr();
+        attr.size(std::max(attr.size().get(), end));
+
+        m_metadataCache.getLocation(acc, uuid, accumulator->flags());
+        acc->second.locations
+            .at(MetadataCache::filterFlagsForLocation(accumulator->flags()))
+            .putBlocks(blocks);
+    });
+}
+
+std::vector<std::pair<boost::icl::discrete_interval<off_t>,
+    messages::fuse::FileBlock>>
+FsLogic::findWriteLocations(const messages::fuse::FileLocation &fileLocation,
+    const off_t offset, const std::size_t size)
+{
+    const auto wantedRange =
+        boost::icl::discrete_interval<off_t>::right_open(offset, offset + size);
 
     messages::fuse::FileBlock defaultBlock{
         fileLocation.storageId(), fileLocation.fileId()};
 
-    if (availableBlockIt == fileLocation.blocks().end())
-        return std::make_tuple(defaultBlock, buf);
-
-    if (boost::icl::contains(availableBlockIt->first, offsetInterval))
-        return std::make_tuple(availableBlockIt->second,
-            asio::buffer(buf, boost::icl::size(
-                                  availableBlockIt->first & wantedRange)));
+    std::vector<std::pair<boost::icl::discrete_interval<off_t>,
+        messages::fuse::FileBlock>>
+        locations;
+
+    auto nextOffset = offset;
+    auto blocks = fileLocation.blocks().equal_range(wantedRange);
+    for (auto it = blocks.first; it != blocks.second; ++it) {
+        auto blockRange = it->first & wantedRange;
+        if (boost::icl::first(blockRange) > nextOffset)
+            locations.emplace_back(
+                boost::icl::discrete_interval<off_t>::right_open(
+                    nextOffset, boost::icl::first(blockRange)),
+                defaultBlock);
+
+        locations.emplace_back(blockRange, it->second);
+        nextOffset = boost::icl::last_next(blockRange);
+    }
 
-    auto blankRange = boost::icl::discrete_interval<off_t>::right_open(
-        offset, boost::icl::first(availableBlockIt->first));
+    if (nextOffset < boost::icl::last_next(wantedRange))
+        locations.emplace_back(boost::icl::discrete_interval<off_t>::right_open(
+                                   nextOffset, boost::icl::last_next(wantedRange)),
+            defaultBlock);
 
-    return std::make_tuple(defaultBlock,
-        asio::buffer(buf, boost::icl::size(blankRange & wantedRange)));
+    return locations;
 }
 
 events::FileAttrEventStream::Handler FsLogic::fileAttrHandler()
@@ -605,7 +1002,10 @@ events::FileAttrEventStream::Handler FsLogic::fileAttrHandler()
                       << "', size: " << (newAttr.size().is_initialized()
                                                 ? newAttr.size().get()
                                                 : -1);
-            auto &attr = acc->second.attr.get();
+            auto &attr = acc.attr();
+            const bool dataChanged = newAttr.mtime() > attr.mtime() ||
+                (newAttr.size().is_initialized() &&
+                    newAttr.size() != attr.size());
 
             if (newAttr.size().is_initialized() &&
                 newAttr.size().get() < attr.size() &&
@@ -613,11 +1013,8 @@ events::FileAttrEventStream::Handler FsLogic::fileAttrHandler()
                 LOG(INFO) << "Truncating blocks attributes for uuid: '"
                           << newAttr.uuid() << "'";
 
-                for (auto &it : acc->second.locations) {
-                    it.second.blocks() &=
-                        boost::icl::discrete_interval<off_t>::right_open(
-                            0, newAttr.size().get());
-                }
+                for (auto &it : acc->second.locations)
+                    it.second.truncateBlocks(newAttr.size().get());
             }
 
             attr.atime(std::max(attr.atime(), newAttr.atime()));
@@ -628,6 +1025,17 @@ events::FileAttrEventStream::Handler FsLogic::fileAttrHandler()
             if (newAttr.size().is_initialized())
                 attr.size(newAttr.size().get());
             attr.uid(newAttr.uid());
+
+            acc.release();
+
+            // Children of a directory might have been changed remotely
+            if (dataChanged) {
+                m_directoryCache.invalidate(newAttr.uuid());
+                if (auto path = m_metadataCache.findPath(newAttr.uuid()))
+                    m_metadataCache.forgetMissingChildren(path.get());
+            }
+
+            invalidateKernelInode(newAttr.uuid(), dataChanged);
         }
     };
 }
@@ -648,14 +1056,20 @@ events::FileLocationEventStream::Handler FsLogic::fileLocationHandler()
 
             LOG(INFO) << "Updating location for uuid: '" << newLocation.uuid()
                       << "'";
+            bool blocksChanged = false;
             for (auto &it : acc->second.locations) {
                 it.second.storageId(newLocation.storageId());
                 it.second.fileId(newLocation.fileId());
 
-                it.second.blocks() = newLocation.blocks();
+                blocksChanged |= it.second.blocks() != newLocation.blocks();
+                it.second.blocks(newLocation);
             }
 
+            acc.release();
             m_metadataCache.notifyNewLocationArrived(newLocation.uuid());
+
+            if (blocksChanged)
+                invalidateKernelInode(newLocation.uuid(), true);
         }
     };
 }
@@ -687,6 +1101,9 @@ int FsLogic::flush(
     boost::filesystem::path path, struct fuse_file_info *const fileInfo)
 {
     DLOG(INFO) << "FUSE: flush(path: " << path << ", ...)";
+
+    auto context = m_fileContextCache.get(fileInfo->fh);
+    publishWrites(context.uuid, context.writeAccumulator);
     return 0;
 }
 
@@ -694,17 +1111,37 @@ int FsLogic::release(
     boost::filesystem::path path, struct fuse_file_info *const fileInfo)
 {
     DLOG(INFO) << "FUSE: release(path: " << path << ", ...)";
-    auto attr = m_metadataCache.getAttr(path);
-
-    m_locExpirationHelper.unpin(attr.uuid());
-    m_attrExpirationHelper.unpin(attr.uuid());
+    releaseFile(fileInfo);
+    return 0;
+}
 
+void FsLogic::releaseFile(struct fuse_file_info *const fileInfo)
+{
     auto context = m_fileContextCache.get(fileInfo->fh);
+
+    // Blocks are published while the metadata is still pinned
+    publishWrites(context.uuid, context.writeAccumulator);
+    {
+        WriteAccumulatorsAccessor acc;
+        if (m_writeAccumulators.find(acc, context.uuid)) {
+            auto &accumulators = acc->second.accumulators;
+            accumulators.erase(std::remove(accumulators.begin(),
+                                   accumulators.end(), context.writeAccumulator),
+                accumulators.end());
+
+            if (--acc->second.handles == 0)
+                m_writeAccumulators.erase(acc);
+        }
+    }
+
+    m_locExpirationHelper.unpin(context.uuid);
+    m_attrExpirationHelper.unpin(context.uuid);
+
     std::exception_ptr lastReleaseException;
     for (auto &it : *context.helperCtxMap) {
         auto &storageId = it.first.first;
         auto &fileId = it.first.second;
-        auto helper = getHelper(attr.uuid(), storageId);
+        auto helper = getHelper(context.uuid, storageId);
         try {
             helper->sh_release(it.second, fileId);
         }
@@ -719,7 +1156,7 @@ int FsLogic::release(
         auto future = m_context->communicator()
                           ->communicate<messages::fuse::FuseResponse>(
                               messages::fuse::Release{
-                                  attr.uuid(), context.handleId->get()});
+                                  context.uuid, context.handleId->get()});
 
         communication::wait(future);
 
@@ -727,11 +1164,10 @@ int FsLogic::release(
     }
     context.helperCtxMap->clear();
 
-    m_eventManager.emitFileReleasedEvent(attr.uuid());
+    m_eventManager.emitFileReleasedEvent(context.uuid);
 
     if (lastReleaseException)
         std::rethrow_exception(lastReleaseException);
-    return 0;
 }
 
 int FsLogic::fsync(boost::filesystem::path path, const int datasync,
@@ -747,12 +1183,14 @@ int FsLogic::opendir(
     boost::filesystem::path path, struct fuse_file_info *const fileInfo)
 {
     DLOG(INFO) << "FUSE: opendir(path: " << path << ", ...)";
+
+    fileInfo->fh = reinterpret_cast<std::uint64_t>(new DirectoryHandle{});
     return 0;
 }
 
 int FsLogic::readdir(boost::filesystem::path path, void *const buf,
     const fuse_fill_dir_t filler, const off_t offset,
-    struct fuse_file_info *const /*fileInfo*/)
+    struct fuse_file_info *const fileInfo)
 {
     DLOG(INFO) << "FUSE: readdir(path: " << path << ", ..., offset: " << offset
                << ", ...)";
@@ -761,41 +1199,338 @@ int FsLogic::readdir(boost::filesystem::path path, void *const buf,
     if (attr.type() != messages::fuse::FileAttr::FileType::directory)
         throw std::errc::not_a_directory;
 
-    auto putEntry = [=](const std::string &name) {
-        if (filler(buf, name.c_str(), nullptr, 0))
-            throw std::errc::not_enough_memory;
+    // Cached listing of the directory is valid as long as the directory is
+    // subscribed for attribute changes
+    m_attrExpirationHelper.markInteresting(attr.uuid(), [&] {
+        m_fsSubscriptions.addFileAttrSubscription(attr.uuid());
+        m_fsSubscriptions.addFileRemovalSubscription(attr.uuid());
+        m_fsSubscriptions.addFileRenamedSubscription(attr.uuid());
+    });
+
+    // Entry n is passed to the filler with offset n + 1, so that the listing
+    // resumes at the first entry that did not fit in the buffer
+    auto putEntry = [=](const std::string &name, const off_t nextOffset) {
+        return filler(buf, name.c_str(), nullptr, nextOffset) == 0;
     };
 
-    std::size_t chunkSize = 1000;
-    putEntry(".");
-    putEntry("..");
+    if (offset < 1 && !putEntry(".", 1))
+        return 0;
+
+    if (offset < 2 && !putEntry("..", 2))
+        return 0;
+
+    DirectoryHandle transientHandle;
+    auto &handle = fileInfo && fileInfo->fh
+        ? *reinterpret_cast<DirectoryHandle *>(fileInfo->fh)
+        : transientHandle;
+
+    off_t childOffset = std::max<off_t>(offset - 2, 0);
+    if (childOffset < handle.offset ||
+        childOffset > handle.offset + static_cast<off_t>(handle.names.size())) {
+        handle.offset = childOffset;
+        handle.names.clear();
+        handle.complete = false;
+    }
 
-    for (off_t currentOffset = 0;; currentOffset += chunkSize) {
+    while (true) {
+        auto index = static_cast<std::size_t>(childOffset - handle.offset);
+        if (index == handle.names.size()) {
+            if (handle.complete)
+                return 0;
+
+            handle.names.clear();
+            if (listCachedChildren(attr.uuid(), path, handle.names)) {
+                handle.offset = 0;
+                handle.complete = true;
+            }
+            else {
+                // A listing started from the beginning is fetched whole, so
+                // that it can be cached
+                handle.offset = childOffset;
+                handle.complete = listChildren(attr.uuid(), path, childOffset,
+                    childOffset == 0 ? std::numeric_limits<std::size_t>::max()
+                                     : DIR_PAGES_IN_FLIGHT,
+                    handle.names);
+            }
+
+            index = static_cast<std::size_t>(childOffset - handle.offset);
+        }
+
+        for (; index < handle.names.size(); ++index, ++childOffset)
+            if (!putEntry(handle.names[index], childOffset + 3))
+                return 0;
+
+        if (handle.complete)
+            return 0;
+    }
+}
+
+bool FsLogic::listChildren(const std::string &uuid,
+    const boost::filesystem::path &path, const off_t offset,
+    const std::size_t maxPages, std::vector<std::string> &names)
+{
+    std::deque<std::future<messages::fuse::FileChildren>> pages;
+    off_t nextPageOffset = offset;
+    std::size_t requestedPages = 0;
+    std::size_t receivedPages = 0;
+    DirectoryCache::Children listing;
+
+    // The modification time is taken before listing, so that a listing
+    // racing with a modification fails revalidation later
+    DirectoryCache::Clock::time_point mtime;
+    if (offset == 0)
+        mtime = m_metadataCache.getAttr(uuid).mtime();
+
+    auto requestPage = [&] {
         messages::fuse::GetFileChildren msg{
-            attr.uuid(), currentOffset, chunkSize};
-        auto future =
+            uuid, nextPageOffset, DIR_PAGE_SIZE};
+
+        pages.emplace_back(
             m_context->communicator()
-                ->communicate<messages::fuse::FileChildren>(std::move(msg));
+                ->communicate<messages::fuse::FileChildren>(std::move(msg)));
+
+        nextPageOffset += DIR_PAGE_SIZE;
+        ++requestedPages;
+    };
+
+    // Most directories fit in a single page, so further pages are requested
+    // only once the first one comes back full
+    requestPage();
 
-        auto fileChildren = communication::wait(future);
+    while (true) {
+        auto fileChildren = communication::wait(pages.front());
+        pages.pop_front();
+        ++receivedPages;
+
+        std::vector<std::string> childUuids;
+        childUuids.reserve(fileChildren.uuidsAndNames().size());
 
         for (const auto &uuidAndName : fileChildren.uuidsAndNames()) {
             auto name = std::get<1>(uuidAndName);
             auto childPath = path / name;
             m_metadataCache.map(std::move(childPath), std::get<0>(uuidAndName));
+            m_listingExpirationHelper.markInteresting(
+                std::get<0>(uuidAndName), [] {});
 
-            putEntry(name);
+            childUuids.emplace_back(std::get<0>(uuidAndName));
+            names.emplace_back(std::move(name));
         }
 
-        if (fileChildren.uuidsAndNames().size() < chunkSize)
-            return 0;
+        if (offset == 0)
+            listing.insert(listing.end(), fileChildren.uuidsAndNames().begin(),
+                fileChildren.uuidsAndNames().end());
+
+        rememberListedChildren(uuid, std::move(childUuids),
+            offset == 0 && receivedPages == 1);
+
+        // Pages still in flight past the end of the directory are dropped
+        if (fileChildren.uuidsAndNames().size() < DIR_PAGE_SIZE) {
+            if (offset == 0)
+                m_directoryCache.put(uuid, std::move(listing), mtime);
+
+            return true;
+        }
+
+        while (pages.size() < DIR_PAGES_IN_FLIGHT && requestedPages < maxPages)
+            requestPage();
+
+        if (pages.empty())
+            return false;
+    }
+}
+
+bool FsLogic::listCachedChildren(const std::string &uuid,
+    const boost::filesystem::path &path, std::vector<std::string> &names)
+{
+    auto listing = m_directoryCache.get(uuid);
+    if (!listing && m_directoryCache.revalidate(
+                        uuid, m_metadataCache.getAttr(uuid).mtime()))
+        listing = m_directoryCache.get(uuid);
+
+    if (!listing)
+        return false;
+
+    std::vector<std::string> childUuids;
+    childUuids.reserve(listing->size());
+    names.reserve(names.size() + listing->size());
+
+    for (auto &uuidAndName : listing.get()) {
+        m_metadataCache.map(path / std::get<1>(uuidAndName),
+            std::get<0>(uuidAndName));
+        m_listingExpirationHelper.markInteresting(
+            std::get<0>(uuidAndName), [] {});
+
+        childUuids.emplace_back(std::move(std::get<0>(uuidAndName)));
+        names.emplace_back(std::move(std::get<1>(uuidAndName)));
     }
+
+    rememberListedChildren(uuid, std::move(childUuids), true);
+    return true;
+}
+
+void FsLogic::updateListings(const boost::filesystem::path &oldPath,
+    const boost::optional<boost::filesystem::path> &newPath)
+{
+    auto oldParentUuid = m_metadataCache.getUuid(oldPath.parent_path());
+    if (oldParentUuid)
+        m_directoryCache.removeChild(
+            oldParentUuid.get(), oldPath.filename().string());
+
+    if (!newPath)
+        return;
+
+    auto newParentUuid = m_metadataCache.getUuid(newPath->parent_path());
+    if (!newParentUuid)
+        return;
+
+    auto uuid = m_metadataCache.getUuid(newPath.get());
+    if (uuid)
+        m_directoryCache.addChild(
+            newParentUuid.get(), uuid.get(), newPath->filename().string());
+    else
+        m_directoryCache.invalidate(newParentUuid.get());
+}
+
+void FsLogic::rememberListedChildren(const std::string &dirUuid,
+    std::vector<std::string> childUuids, const bool restart)
+{
+    if (!m_context->options()->get_enable_dir_prefetch())
+        return;
+
+    std::unique_lock<std::mutex> lock{m_listedDirectoriesMutex};
+
+    auto it = std::find_if(m_listedDirectories.begin(),
+        m_listedDirectories.end(),
+        [&](const ListedDirectory &dir) { return dir.uuid == dirUuid; });
+
+    if (it != m_listedDirectories.end()) {
+        m_listedDirectories.splice(
+            m_listedDirectories.begin(), m_listedDirectories, it);
+    }
+    else {
+        if (m_listedDirectories.size() >= LISTED_DIRECTORIES_LIMIT) {
+            if (!m_listedDirectories.back().prefetching)
+                --m_pendingListedDirectories;
+
+            m_listedDirectories.pop_back();
+        }
+
+        m_listedDirectories.emplace_front();
+        m_listedDirectories.front().uuid = dirUuid;
+        ++m_pendingListedDirectories;
+    }
+
+    auto &dir = m_listedDirectories.front();
+    if (restart) {
+        dir.childUuids.clear();
+        if (dir.prefetching)
+            ++m_pendingListedDirectories;
+
+        dir.prefetching = false;
+    }
+
+    if (dir.prefetching) {
+        lock.unlock();
+        prefetchAttrs(std::move(childUuids));
+        return;
+    }
+
+    dir.childUuids.insert(dir.childUuids.end(),
+        std::make_move_iterator(childUuids.begin()),
+        std::make_move_iterator(childUuids.end()));
+}
+
+void FsLogic::statAhead(const std::string &dirUuid)
+{
+    if (m_pendingListedDirectories == 0)
+        return;
+
+    std::vector<std::string> childUuids;
+
+    {
+        std::lock_guard<std::mutex> guard{m_listedDirectoriesMutex};
+
+        auto it = std::find_if(m_listedDirectories.begin(),
+            m_listedDirectories.end(),
+            [&](const ListedDirectory &dir) { return dir.uuid == dirUuid; });
+
+        if (it == m_listedDirectories.end() || it->prefetching)
+            return;
+
+        it->prefetching = true;
+        --m_pendingListedDirectories;
+        childUuids.swap(it->childUuids);
+    }
+
+    prefetchAttrs(std::move(childUuids));
+}
+
+void FsLogic::prefetchAttrs(std::vector<std::string> uuids)
+{
+    if (uuids.empty())
+        return;
+
+    const bool parallel = m_context->options()->get_enable_parallel_getattr();
+
+    // Prefetch runs on its own thread, so that it never holds up reads and
+    // writes waiting for the IO threads
+    asio::post(m_prefetchService, [this, parallel, uuids = std::move(uuids)] {
+        const auto deadline =
+            std::chrono::steady_clock::now() + communication::DEFAULT_TIMEOUT;
+
+        auto fetch = [&](const std::string &uuid) {
+            return m_context->communicator()
+                ->communicate<messages::fuse::FileAttr>(
+                    messages::fuse::GetFileAttr{uuid});
+        };
+
+        // Prefetched files are not subscribed for changes until they are
+        // looked up, so their attributes are kept only briefly
+        auto store = [&](std::future<messages::fuse::FileAttr> &future) {
+            try {
+                auto attr = communication::wait(future,
+                    std::max<std::chrono::steady_clock::duration>(
+                        deadline - std::chrono::steady_clock::now(), 1ms));
+
+                if (!attr.size().is_initialized())
+                    return;
+
+                const auto uuid = attr.uuid();
+                if (m_metadataCache.putAttr(std::move(attr)))
+                    m_listingExpirationHelper.markInteresting(
+                        uuid, [] {}, PREFETCHED_ATTRS_TTL);
+            }
+            catch (...) {
+                // Prefetch is best effort; the attributes will be fetched
+                // again when they are actually needed
+            }
+        };
+
+        const auto maxInFlight = parallel ? PREFETCH_ATTRS_IN_FLIGHT : 1;
+        std::deque<std::future<messages::fuse::FileAttr>> futures;
+        for (const auto &uuid : uuids) {
+            if (m_metadataCache.hasAttr(uuid))
+                continue;
+
+            if (futures.size() >= maxInFlight) {
+                store(futures.front());
+                futures.pop_front();
+            }
+
+            futures.emplace_back(fetch(uuid));
+        }
+
+        for (auto &future : futures)
+            store(future);
+    });
 }
 
 int FsLogic::releasedir(
     boost::filesystem::path path, struct fuse_file_info *const fileInfo)
 {
     DLOG(INFO) << "FUSE: releasedir(path: " << path << ", ...)";
+
+    delete reinterpret_cast<DirectoryHandle *>(fileInfo->fh);
     return 0;
 }
 
@@ -822,6 +1557,329 @@ int FsLogic::create(boost::filesystem::path path, const mode_t mode,
     return 0;
 }
 
+void FsLogic::lookup(const fuse_ino_t parent, const std::string &name,
+    struct fuse_entry_param *const entry)
+{
+    DLOG(INFO) << "FUSE: lookup(parent: " << parent << ", name: " << name
+               << ")";
+
+    fillEntry(parent, name, entry);
+    statAhead(inodeToUuid(parent));
+}
+
+void FsLogic::forget(const fuse_ino_t ino, const std::uint64_t nlookup)
+{
+    DLOG(INFO) << "FUSE: forget(ino: " << ino << ", nlookup: " << nlookup
+               << ")";
+
+    auto uuid = m_inodeCache.forget(ino, nlookup);
+    if (uuid)
+        m_attrExpirationHelper.unpin(uuid.get());
+}
+
+void FsLogic::getattr(const fuse_ino_t ino, struct stat *const statbuf)
+{
+    DLOG(INFO) << "FUSE: getattr(ino: " << ino << ", ...)";
+
+    auto uuid = inodeToUuid(ino);
+    publishWrites(uuid);
+    auto attr = m_metadataCache.getAttr(uuid);
+
+    *statbuf = {};
+    fillStat(attr, statbuf);
+    statbuf->st_ino = ino;
+}
+
+void FsLogic::setattr(const fuse_ino_t ino, const struct stat &attr,
+    const int toSet, struct stat *const statbuf)
+{
+    DLOG(INFO) << "FUSE: setattr(ino: " << ino << ", toSet: " << toSet
+               << ", ...)";
+
+    if (toSet & (FUSE_SET_ATTR_UID | FUSE_SET_ATTR_GID))
+        throw std::errc::function_not_supported;
+
+    auto uuid = inodeToUuid(ino);
+
+    if (toSet & FUSE_SET_ATTR_MODE)
+        changeMode(uuid, attr.st_mode);
+
+    if (toSet & FUSE_SET_ATTR_SIZE)
+        truncateFile(uuid, attr.st_size);
+
+    if (toSet & (FUSE_SET_ATTR_ATIME | FUSE_SET_ATTR_MTIME |
+                    FUSE_SET_ATTR_ATIME_NOW | FUSE_SET_ATTR_MTIME_NOW)) {
+        // Times that are not being set retain their current values; zero
+        // stands for the current time
+        auto current = m_metadataCache.getAttr(uuid);
+        auto timeToSet = [&](const int setFlag, const int setNowFlag,
+            const std::time_t requested,
+            const std::chrono::system_clock::time_point currentTime) {
+            if (toSet & setNowFlag)
+                return std::time_t{0};
+            if (toSet & setFlag)
+                return requested;
+            return std::chrono::system_clock::to_time_t(currentTime);
+        };
+
+        updateTimes(uuid, timeToSet(FUSE_SET_ATTR_ATIME,
+                              FUSE_SET_ATTR_ATIME_NOW, attr.st_atime,
+                              current.atime()),
+            timeToSet(FUSE_SET_ATTR_MTIME, FUSE_SET_ATTR_MTIME_NOW,
+                attr.st_mtime, current.mtime()));
+    }
+
+    getattr(ino, statbuf);
+}
+
+void FsLogic::mknod(const fuse_ino_t parent, const std::string &name,
+    const mode_t mode, const dev_t dev, struct fuse_entry_param *const entry)
+{
+    DLOG(INFO) << "FUSE: mknod(parent: " << parent << ", name: " << name
+               << ", mode: " << std::oct << mode << ", dev: " << dev << ")";
+
+    createFile(childPath(parent, name), mode, {one::helpers::Flag::RDWR});
+    fillEntry(parent, name, entry);
+}
+
+void FsLogic::mkdir(const fuse_ino_t parent, const std::string &name,
+    const mode_t mode, struct fuse_entry_param *const entry)
+{
+    DLOG(INFO) << "FUSE: mkdir(parent: " << parent << ", name: " << name
+               << ", mode: " << std::oct << mode << ")";
+
+    mkdir(childPath(parent, name), mode);
+    fillEntry(parent, name, entry);
+}
+
+void FsLogic::unlink(const fuse_ino_t parent, const std::string &name)
+{
+    DLOG(INFO) << "FUSE: unlink(parent: " << parent << ", name: " << name
+               << ")";
+
+    removeFile(childPath(parent, name));
+}
+
+void FsLogic::rmdir(const fuse_ino_t parent, const std::string &name)
+{
+    DLOG(INFO) << "FUSE: rmdir(parent: " << parent << ", name: " << name
+               << ")";
+
+    removeFile(childPath(parent, name));
+}
+
+void FsLogic::rename(const fuse_ino_t parent, const std::string &name,
+    const fuse_ino_t newParent, const std::string &newName)
+{
+    DLOG(INFO) << "FUSE: rename(parent: " << parent << ", name: " << name
+               << ", newParent: " << newParent << ", newName: " << newName
+               << ")";
+
+    rename(childPath(parent, name), childPath(newParent, newName));
+}
+
+void FsLogic::open(const fuse_ino_t ino, struct fuse_file_info *const fileInfo)
+{
+    DLOG(INFO) << "FUSE: open(ino: " << ino << ", flags: " << fileInfo->flags
+               << " ...)";
+
+    auto uuid = inodeToUuid(ino);
+    auto location = m_metadataCache.getLocation(
+        uuid, one::helpers::IStorageHelper::maskToFlags(fileInfo->flags));
+    auto helper = getHelper(uuid, location.storageId());
+    openFile(uuid, fileInfo);
+}
+
+std::size_t FsLogic::read(const fuse_ino_t ino, asio::mutable_buffer buf,
+    const off_t offset, struct fuse_file_info *const fileInfo)
+{
+    DLOG(INFO) << "FUSE: read(ino: " << ino
+               << ", bufferSize: " << asio::buffer_size(buf)
+               << ", offset: " << offset << ", ...)";
+
+    return readFile(buf, offset, fileInfo);
+}
+
+std::size_t FsLogic::write(const fuse_ino_t ino, asio::const_buffer buf,
+    const off_t offset, struct fuse_file_info *const fileInfo)
+{
+    DLOG(INFO) << "FUSE: write(ino: " << ino
+               << ", bufferSize: " << asio::buffer_size(buf)
+               << ", offset: " << offset << ", ...)";
+
+    return writeFile(buf, offset, fileInfo);
+}
+
+void FsLogic::flush(const fuse_ino_t ino, struct fuse_file_info *const fileInfo)
+{
+    DLOG(INFO) << "FUSE: flush(ino: " << ino << ", ...)";
+
+    auto context = m_fileContextCache.get(fileInfo->fh);
+    publishWrites(context.uuid, context.writeAccumulator);
+}
+
+void FsLogic::release(
+    const fuse_ino_t ino, struct fuse_file_info *const fileInfo)
+{
+    DLOG(INFO) << "FUSE: release(ino: " << ino << ", ...)";
+    releaseFile(fileInfo);
+}
+
+void FsLogic::fsync(const fuse_ino_t ino, const int datasync,
+    struct fuse_file_info *const fileInfo)
+{
+    DLOG(INFO) << "FUSE: fsync(ino: " << ino << ", datasync: " << datasync
+               << ", ...)";
+
+    throw std::errc::function_not_supported;
+}
+
+std::vector<std::string> FsLogic::readdir(const fuse_ino_t ino)
+{
+    DLOG(INFO) << "FUSE: readdir(ino: " << ino << ")";
+
+    auto uuid = inodeToUuid(ino);
+    auto attr = m_metadataCache.getAttr(uuid);
+    if (attr.type() != messages::fuse::FileAttr::FileType::directory)
+        throw std::errc::not_a_directory;
+
+    m_attrExpirationHelper.markInteresting(uuid, [&] {
+        m_fsSubscriptions.addFileAttrSubscription(uuid);
+        m_fsSubscriptions.addFileRemovalSubscription(uuid);
+        m_fsSubscriptions.addFileRenamedSubscription(uuid);
+    });
+
+    auto path = m_metadataCache.getPath(uuid);
+
+    std::vector<std::string> names;
+    if (!listCachedChildren(uuid, path, names))
+        listChildren(uuid, path, 0, std::numeric_limits<std::size_t>::max(),
+            names);
+
+    return names;
+}
+
+void FsLogic::statfs(const fuse_ino_t ino, struct statvfs *const statInfo)
+{
+    DLOG(INFO) << "FUSE: statfs(ino: " << ino << ", ...)";
+
+    *statInfo = {};
+    statInfo->f_fsid = m_fsid;
+}
+
+void FsLogic::create(const fuse_ino_t parent, const std::string &name,
+    const mode_t mode, struct fuse_file_info *const fileInfo,
+    struct fuse_entry_param *const entry)
+{
+    DLOG(INFO) << "FUSE: create(parent: " << parent << ", name: " << name
+               << ", mode: " << std::oct << mode << ")";
+
+    // Potential race condition, file might be modified between create and open
+    auto fileUuid = createFile(childPath(parent, name), mode,
+        one::helpers::IStorageHelper::maskToFlags(fileInfo->flags));
+    openFile(fileUuid, fileInfo);
+    fillEntry(parent, name, entry);
+}
+
+std::string FsLogic::inodeToUuid(const fuse_ino_t ino)
+{
+    if (ino == FUSE_ROOT_ID && !m_inodeCache.hasRoot()) {
+        auto attr = m_metadataCache.getAttr(boost::filesystem::path{"/"});
+        m_attrExpirationHelper.pin(attr.uuid(), [&] {
+            m_fsSubscriptions.addFileAttrSubscription(attr.uuid());
+        });
+        m_inodeCache.setRoot(attr.uuid());
+    }
+
+    return m_inodeCache.uuid(ino);
+}
+
+boost::filesystem::path FsLogic::childPath(
+    const fuse_ino_t parent, const std::string &name)
+{
+    return m_metadataCache.getPath(inodeToUuid(parent)) / name;
+}
+
+fuse_ino_t FsLogic::lookupInode(const std::string &uuid)
+{
+    auto inode = m_inodeCache.lookup(uuid);
+    if (inode.second) {
+        // Metadata of files known to the kernel must outlive the kernel's
+        // references, as their cached paths are used to resolve children
+        m_attrExpirationHelper.pin(uuid, [&] {
+            m_metadataCache.getAttr(uuid);
+            m_fsSubscriptions.addFileAttrSubscription(uuid);
+            m_fsSubscriptions.addFileRemovalSubscription(uuid);
+            m_fsSubscriptions.addFileRenamedSubscription(uuid);
+        });
+    }
+
+    return inode.first;
+}
+
+void FsLogic::fillEntry(const fuse_ino_t parent, const std::string &name,
+    struct fuse_entry_param *const entry)
+{
+    auto attr = m_metadataCache.getAttr(childPath(parent, name));
+    if (publishWrites(attr.uuid()))
+        attr = m_metadataCache.getAttr(attr.uuid());
+
+    *entry = {};
+    entry->ino = lookupInode(attr.uuid());
+    fillStat(attr, &entry->attr);
+    entry->attr.st_ino = entry->ino;
+    entry->attr_timeout = m_kernelCacheTimeout;
+    entry->entry_timeout = m_kernelCacheTimeout;
+}
+
+void FsLogic::enableKernelCache(
+    struct fuse_chan *const channel, const double timeout)
+{
+    m_kernelCacheTimeout = timeout;
+    m_fuseChannel = channel;
+}
+
+double FsLogic::attrTimeout() const { return m_kernelCacheTimeout; }
+
+void FsLogic::invalidateKernelInode(const std::string &uuid, const bool data)
+{
+    auto channel = m_fuseChannel.load();
+    if (!channel)
+        return;
+
+    for (const auto inode : m_inodeCache.inodes(uuid)) {
+        // A negative offset invalidates only the attributes
+        const auto res =
+            fuse_lowlevel_notify_inval_inode(channel, inode, data ? 0 : -1, 0);
+
+        if (res != 0 && res != -ENOENT)
+            LOG(WARNING) << "Unable to invalidate kernel cache of inode "
+                         << inode << " (uuid: '" << uuid
+                         << "'): " << std::strerror(-res);
+    }
+}
+
+void FsLogic::invalidateKernelEntry(const boost::filesystem::path &path)
+{
+    auto channel = m_fuseChannel.load();
+    if (!channel)
+        return;
+
+    auto parentUuid = m_metadataCache.getUuid(path.parent_path());
+    if (!parentUuid)
+        return;
+
+    const auto name = path.filename().string();
+    for (const auto parent : m_inodeCache.inodes(parentUuid.get())) {
+        const auto res = fuse_lowlevel_notify_inval_entry(
+            channel, parent, name.c_str(), name.size());
+
+        if (res != 0 && res != -ENOENT)
+            LOG(WARNING) << "Unable to invalidate kernel entry " << path
+                         << ": " << std::strerror(-res);
+    }
+}
+
 HelpersCache::HelperPtr FsLogic::getHelper(
     const std::string &fileUuid, const std::string &storageId)
 {
@@ -847,9 +1905,11 @@ void FsLogic::removeFile(boost::filesystem::path path)
     auto uuid = uuidAcc->second;
 
     m_metadataCache.removePathMapping(uuidAcc, metaAcc);
-    metaAcc->second.path = boost::none;
 
     metaAcc.release();
+    uuidAcc.release();
+    updateListings(path, {});
+    m_directoryCache.invalidate(uuid);
     m_locExpirationHelper.expire(uuid);
     m_attrExpirationHelper.expire(uuid);
 }
@@ -870,6 +1930,8 @@ const std::string FsLogic::createFile(boost::filesystem::path path,
 
     auto location = communication::wait(future);
     m_metadataCache.map(path, location, flags);
+    m_directoryCache.addChild(
+        parentAttr.uuid(), location.uuid(), path.filename().string());
 
     return location.uuid();
 }
@@ -886,7 +1948,11 @@ void FsLogic::openFile(
     auto &location = metaAcc->second.locations.at(
         MetadataCache::filterFlagsForLocation(flagsSet));
 
-    fileInfo->direct_io = 1;
+    if (m_fuseChannel)
+        fileInfo->keep_cache = 1;
+    else
+        fileInfo->direct_io = 1;
+
     fileInfo->fh = acc->first;
 
     acc->second.uuid = fileUuid;
@@ -898,6 +1964,28 @@ void FsLogic::openFile(
     acc->second.helperCtxMap =
         std::make_shared<FileContextCache::HelperCtxMap>();
 
+    const auto syncAheadMaxSize =
+        m_context->options()->get_sync_ahead_max_size();
+    if (syncAheadMaxSize > 0)
+        acc->second.syncAhead = std::make_shared<SyncAhead>(
+            m_context->options()->get_sync_ahead_min_size(), syncAheadMaxSize);
+
+    {
+        WriteAccumulatorsAccessor writesAcc;
+        m_writeAccumulators.insert(writesAcc, fileUuid);
+        ++writesAcc->second.handles;
+        acc->second.pendingWrites = writesAcc->second.pending;
+
+        // Blocks are never written through read-only handles
+        if ((fileInfo->flags & O_ACCMODE) != O_RDONLY) {
+            acc->second.writeAccumulator = std::make_shared<WriteAccumulator>(
+                flagsSet, WRITE_ACCUMULATOR_MAX_RANGES,
+                writesAcc->second.pending);
+            writesAcc->second.accumulators.emplace_back(
+                acc->second.writeAccumulator);
+        }
+    }
+
     metaAcc.release();
 
     m_eventManager.emitFileOpenedEvent(fileUuid);
@@ -931,21 +2019,25 @@ events::FileRemovalEventStream::Handler FsLogic::fileRemovalHandler()
             }
 
             metaAcc->second.state = MetadataCache::FileState::removedUpstream;
+            metaAcc.release();
 
-            if (metaAcc->second.path) {
-                auto path = metaAcc->second.path.get();
-                metaAcc.release();
+            if (auto path = m_metadataCache.findPath(event->fileUuid())) {
+                updateListings(path.get(), {});
                 try {
+                    // Let the kernel forget the entry if it cannot be removed
+                    // through the mountpoint
                     auto dir = m_context->options()->get_mountpoint();
-                    std::remove((dir / path).c_str());
+                    if (std::remove((dir / path.get()).c_str()) != 0)
+                        invalidateKernelEntry(path.get());
                 }
                 catch (std::system_error &e) {
-                    LOG(WARNING) << "Unable to remove file (path: " << path
-                                 << "): " << e.what();
+                    LOG(WARNING) << "Unable to remove file (path: "
+                                 << path.get() << "): " << e.what();
                 }
             }
 
-            metaAcc.release();
+            m_directoryCache.invalidate(event->fileUuid());
+            invalidateKernelInode(event->fileUuid(), false);
             m_locExpirationHelper.expire(event->fileUuid());
             m_attrExpirationHelper.expire(event->fileUuid());
             LOG(INFO) << "File remove event received: " << event->fileUuid();
@@ -978,8 +2070,10 @@ events::FileRenamedEventStream::Handler FsLogic::fileRenamedHandler()
             }
 
             metaAcc->second.state = MetadataCache::FileState::renamedUpstream;
+            metaAcc.release();
 
-            if (!metaAcc->second.path) {
+            auto cachedPath = m_metadataCache.findPath(topEntry.oldUuid());
+            if (!cachedPath) {
                 LOG(INFO) << "Received a file renamed event for '"
                           << topEntry.oldUuid()
                           << "', but the file does not have a cached path.";
@@ -987,14 +2081,17 @@ events::FileRenamedEventStream::Handler FsLogic::fileRenamedHandler()
                 continue;
             }
 
-            auto fromPath = metaAcc->second.path.get();
-            metaAcc.release();
+            auto fromPath = cachedPath.get();
 
             auto dir = m_context->options()->get_mountpoint();
             auto toPath = boost::filesystem::path(topEntry.newPath());
 
             try {
-                std::rename((dir / fromPath).c_str(), (dir / toPath).c_str());
+                if (std::rename((dir / fromPath).c_str(),
+                        (dir / toPath).c_str()) != 0) {
+                    invalidateKernelEntry(fromPath);
+                    invalidateKernelEntry(toPath);
+                }
             }
             catch (std::system_error &e) {
                 LOG(WARNING) << "Unable to rename file (from: " << fromPath
@@ -1003,6 +2100,9 @@ events::FileRenamedEventStream::Handler FsLogic::fileRenamedHandler()
 
             m_metadataCache.remapFile(
                 topEntry.oldUuid(), topEntry.newUuid(), topEntry.newPath());
+            updateListings(fromPath, toPath);
+            m_directoryCache.invalidate(topEntry.oldUuid());
+            m_inodeCache.rename(topEntry.oldUuid(), topEntry.newUuid());
 
             m_attrExpirationHelper.rename(
                 topEntry.oldUuid(), topEntry.newUuid(), [&] {
@@ -1020,10 +2120,14 @@ events::FileRenamedEventStream::Handler FsLogic::fileRenamedHandler()
                     m_fsSubscriptions.addFileRenamedSubscription(
                         topEntry.newUuid());
                 });
+            m_listingExpirationHelper.rename(
+                topEntry.oldUuid(), topEntry.newUuid(), [] {});
 
             for (auto &childEntry : event->childEntries()) {
                 m_metadataCache.remapFile(childEntry.oldUuid(),
                     childEntry.newUuid(), childEntry.newPath());
+                m_directoryCache.invalidate(childEntry.oldUuid());
+                m_inodeCache.rename(childEntry.oldUuid(), childEntry.newUuid());
 
                 m_attrExpirationHelper.rename(
                     childEntry.oldUuid(), childEntry.newUuid(), [&] {
@@ -1041,6 +2145,8 @@ events::FileRenamedEventStream::Handler FsLogic::fileRenamedHandler()
                         m_fsSubscriptions.addFileRenamedSubscription(
                             childEntry.newUuid());
                     });
+                m_listingExpirationHelper.rename(
+                    childEntry.oldUuid(), childEntry.newUuid(), [] {});
             }
 
             LOG(INFO) << "File renamed event received: " << topEntry.oldUuid();
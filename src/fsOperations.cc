@@ -19,25 +19,27 @@
 #include <execinfo.h>
 
 #include <array>
+#include <cstdint>
 #include <exception>
+#include <iterator>
 #include <memory>
+#include <string>
 #include <system_error>
+#include <vector>
 
 using namespace one::client;
 
 namespace {
 
-template <typename... Args1, typename... Args2>
-int wrap(int (FsLogic::*operation)(Args2...), Args1 &&... args)
+/**
+ * Translates the exception currently being handled into a FUSE error code.
+ * Must be called from within a catch block.
+ * @return Negated errno value.
+ */
+int translateException()
 {
     try {
-        auto &fsLogic =
-            static_cast<FsLogicWrapper *>(fuse_get_context()->private_data)
-                ->logic;
-
-        one::helpers::activateFuseSession();
-
-        return ((*fsLogic).*operation)(std::forward<Args1>(args)...);
+        throw;
     }
     catch (const std::errc errc) {
         return -1 * static_cast<int>(errc);
@@ -71,6 +73,99 @@ int wrap(int (FsLogic::*operation)(Args2...), Args1 &&... args)
     }
 }
 
+template <typename... Args1, typename... Args2>
+int wrap(int (FsLogic::*operation)(Args2...), Args1 &&... args)
+{
+    try {
+        auto &fsLogic =
+            static_cast<FsLogicWrapper *>(fuse_get_context()->private_data)
+                ->logic;
+
+        one::helpers::activateFuseSession();
+
+        return ((*fsLogic).*operation)(std::forward<Args1>(args)...);
+    }
+    catch (...) {
+        return translateException();
+    }
+}
+
+/**
+ * Calls a low-level operation on FsLogic and replies to the request with an
+ * error if the operation fails. @p reply is called with the operation's
+ * result on success and is responsible for replying to the request.
+ * While the operation runs, blocking waits of the calling thread are
+ * interrupted together with the request.
+ */
+template <typename Operation, typename Reply>
+void wrapLowLevel(fuse_req_t req, Operation &&operation, Reply &&reply)
+{
+    try {
+        auto &fsLogic =
+            static_cast<FsLogicWrapper *>(fuse_req_userdata(req))->logic;
+
+        one::helpers::activateFuseSession(req);
+        auto result = operation(*fsLogic);
+        one::helpers::deactivateFuseSession();
+
+        reply(std::move(result));
+    }
+    catch (...) {
+        one::helpers::deactivateFuseSession();
+        fuse_reply_err(req, -1 * translateException());
+    }
+}
+
+/**
+ * Variant of @c wrapLowLevel for operations that do not return a result.
+ */
+template <typename Operation, typename Reply>
+void wrapLowLevelVoid(fuse_req_t req, Operation &&operation, Reply &&reply)
+{
+    try {
+        auto &fsLogic =
+            static_cast<FsLogicWrapper *>(fuse_req_userdata(req))->logic;
+
+        one::helpers::activateFuseSession(req);
+        operation(*fsLogic);
+        one::helpers::deactivateFuseSession();
+
+        reply();
+    }
+    catch (...) {
+        one::helpers::deactivateFuseSession();
+        fuse_reply_err(req, -1 * translateException());
+    }
+}
+
+/**
+ * Variant of @c wrapLowLevelVoid for requests that must not be replied to
+ * with an error, such as @c forget. Failures of the operation are only
+ * logged.
+ */
+template <typename Operation>
+void wrapLowLevelNoReply(fuse_req_t req, Operation &&operation)
+{
+    try {
+        auto &fsLogic =
+            static_cast<FsLogicWrapper *>(fuse_req_userdata(req))->logic;
+
+        operation(*fsLogic);
+    }
+    catch (...) {
+        LOG(WARNING) << "Low-level operation without reply failed with error: "
+                     << translateException();
+    }
+}
+
+/**
+ * Directory listing snapshot held in @c fuse_file_info::fh between low-level
+ * @c opendir and @c releasedir calls.
+ */
+struct DirHandle {
+    std::vector<std::string> names;
+};
+
 extern "C" {
 
 int wrap_access(const char *path, int mode)
@@ -179,6 +274,196 @@ void *init(struct fuse_conn_info * /*conn*/)
     return fuse_get_context()->private_data;
 }
 
+void ll_lookup(fuse_req_t req, fuse_ino_t parent, const char *name)
+{
+    struct fuse_entry_param entry;
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) { fsLogic.lookup(parent, name, &entry); },
+        [&] { fuse_reply_entry(req, &entry); });
+}
+
+void ll_forget(fuse_req_t req, fuse_ino_t ino, unsigned long nlookup)
+{
+    wrapLowLevelNoReply(
+        req, [&](FsLogic &fsLogic) { fsLogic.forget(ino, nlookup); });
+    fuse_reply_none(req);
+}
+
+void ll_getattr(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi)
+{
+    struct stat statbuf;
+    double timeout;
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) {
+            fsLogic.getattr(ino, &statbuf);
+            timeout = fsLogic.attrTimeout();
+        },
+        [&] { fuse_reply_attr(req, &statbuf, timeout); });
+}
+void ll_setattr(fuse_req_t req, fuse_ino_t ino, struct stat *attr, int toSet,
+    struct fuse_file_info *fi)
+{
+    struct stat statbuf;
+    double timeout;
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) {
+            fsLogic.setattr(ino, *attr, toSet, &statbuf);
+            timeout = fsLogic.attrTimeout();
+        },
+        [&] { fuse_reply_attr(req, &statbuf, timeout); });
+}
+void ll_mknod(fuse_req_t req, fuse_ino_t parent, const char *name,
+    mode_t mode, dev_t dev)
+{
+    struct fuse_entry_param entry;
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) {
+            fsLogic.mknod(parent, name, mode, dev, &entry);
+        },
+        [&] { fuse_reply_entry(req, &entry); });
+}
+void ll_mkdir(fuse_req_t req, fuse_ino_t parent, const char *name, mode_t mode)
+{
+    struct fuse_entry_param entry;
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) { fsLogic.mkdir(parent, name, mode, &entry); },
+        [&] { fuse_reply_entry(req, &entry); });
+}
+void ll_unlink(fuse_req_t req, fuse_ino_t parent, const char *name)
+{
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) { fsLogic.unlink(parent, name); },
+        [&] { fuse_reply_err(req, 0); });
+}
+void ll_rmdir(fuse_req_t req, fuse_ino_t parent, const char *name)
+{
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) { fsLogic.rmdir(parent, name); },
+        [&] { fuse_reply_err(req, 0); });
+}
+void ll_rename(fuse_req_t req, fuse_ino_t parent, const char *name,
+    fuse_ino_t newParent, const char *newName)
+{
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) {
+            fsLogic.rename(parent, name, newParent, newName);
+        },
+        [&] { fuse_reply_err(req, 0); });
+}
+void ll_open(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi)
+{
+    wrapLowLevelVoid(req, [&](FsLogic &fsLogic) { fsLogic.open(ino, fi); },
+        [&] { fuse_reply_open(req, fi); });
+}
+void ll_read(fuse_req_t req, fuse_ino_t ino, size_t size, off_t offset,
+    struct fuse_file_info *fi)
+{
+    std::unique_ptr<char[]> buf{new char[size]};
+    wrapLowLevel(req,
+        [&](FsLogic &fsLogic) {
+            return fsLogic.read(ino, asio::buffer(buf.get(), size), offset, fi);
+        },
+        [&](std::size_t bytesRead) {
+            fuse_reply_buf(req, buf.get(), bytesRead);
+        });
+}
+void ll_write(fuse_req_t req, fuse_ino_t ino, const char *buf, size_t size,
+    off_t offset, struct fuse_file_info *fi)
+{
+    wrapLowLevel(req,
+        [&](FsLogic &fsLogic) {
+            return fsLogic.write(ino, asio::buffer(buf, size), offset, fi);
+        },
+        [&](std::size_t bytesWritten) {
+            fuse_reply_write(req, bytesWritten);
+        });
+}
+void ll_flush(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi)
+{
+    wrapLowLevelVoid(req, [&](FsLogic &fsLogic) { fsLogic.flush(ino, fi); },
+        [&] { fuse_reply_err(req, 0); });
+}
+void ll_release(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi)
+{
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) { fsLogic.release(ino, fi); },
+        [&] { fuse_reply_err(req, 0); });
+}
+void ll_fsync(
+    fuse_req_t req, fuse_ino_t ino, int datasync, struct fuse_file_info *fi)
+{
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) { fsLogic.fsync(ino, datasync, fi); },
+        [&] { fuse_reply_err(req, 0); });
+}
+void ll_opendir(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi)
+{
+    wrapLowLevel(req,
+        [&](FsLogic &fsLogic) { return fsLogic.readdir(ino); },
+        [&](std::vector<std::string> names) {
+            auto dirHandle = std::make_unique<DirHandle>();
+            dirHandle->names.emplace_back(".");
+            dirHandle->names.emplace_back("..");
+            std::move(names.begin(), names.end(),
+                std::back_inserter(dirHandle->names));
+
+            fi->fh = reinterpret_cast<std::uint64_t>(dirHandle.get());
+            if (fuse_reply_open(req, fi) == 0)
+                dirHandle.release();
+        });
+}
+void ll_readdir(fuse_req_t req, fuse_ino_t ino, size_t size, off_t offset,
+    struct fuse_file_info *fi)
+{
+    const auto &names = reinterpret_cast<DirHandle *>(fi->fh)->names;
+
+    // Entries for which inodes are not known are reported with
+    // FUSE_UNKNOWN_INO, the same way the high-level API does
+    struct stat statbuf = {};
+    statbuf.st_ino = 0xffffffff;
+
+    std::vector<char> buf(size);
+    std::size_t used = 0;
+    for (auto i = static_cast<std::size_t>(offset); i < names.size(); ++i) {
+        const auto entrySize = fuse_add_direntry(req, buf.data() + used,
+            size - used, names[i].c_str(), &statbuf, i + 1);
+
+        if (entrySize > size - used)
+            break;
+
+        used += entrySize;
+    }
+
+    fuse_reply_buf(req, buf.data(), used);
+}
+void ll_releasedir(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi)
+{
+    delete reinterpret_cast<DirHandle *>(fi->fh);
+    fuse_reply_err(req, 0);
+}
+void ll_fsyncdir(
+    fuse_req_t req, fuse_ino_t ino, int datasync, struct fuse_file_info *fi)
+{
+    fuse_reply_err(req, 0);
+}
+void ll_statfs(fuse_req_t req, fuse_ino_t ino)
+{
+    struct statvfs statInfo;
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) { fsLogic.statfs(ino, &statInfo); },
+        [&] { fuse_reply_statfs(req, &statInfo); });
+}
+void ll_create(fuse_req_t req, fuse_ino_t parent, const char *name,
+    mode_t mode, struct fuse_file_info *fi)
+{
+    struct fuse_entry_param entry;
+    wrapLowLevelVoid(req,
+        [&](FsLogic &fsLogic) {
+            fsLogic.create(parent, name, mode, fi, &entry);
+        },
+        [&] { fuse_reply_create(req, &entry, fi); });
+}
+
 } // extern "C"
 } // namespace
 
@@ -216,3 +501,32 @@ struct fuse_operations fuseOperations()
 
     return operations;
 }
+
+struct fuse_lowlevel_ops fuseLowLevelOperations()
+{
+    struct fuse_lowlevel_ops operations = {nullptr};
+
+    operations.lookup = ll_lookup;
+    operations.forget = ll_forget;
+    operations.getattr = ll_getattr;
+    operations.setattr = ll_setattr;
+    operations.mknod = ll_mknod;
+    operations.mkdir = ll_mkdir;
+    operations.unlink = ll_unlink;
+    operations.rmdir = ll_rmdir;
+    operations.rename = ll_rename;
+    operations.open = ll_open;
+    operations.read = ll_read;
+    operations.write = ll_write;
+    operations.flush = ll_flush;
+    operations.release = ll_release;
+    operations.fsync = ll_fsync;
+    operations.opendir = ll_opendir;
+    operations.readdir = ll_readdir;
+    operations.releasedir = ll_releasedir;
+    operations.fsyncdir = ll_fsyncdir;
+    operations.statfs = ll_statfs;
+    operations.create = ll_create;
+
+    return operations;
+}
@@ -19,9 +19,42 @@
 namespace one {
 namespace client {
 
-FsSubscriptions::FsSubscriptions(events::EventManager &eventManager)
+using std::placeholders::_1;
+
+FsSubscriptions::FsSubscriptions(events::EventManager &eventManager,
+    std::shared_ptr<Scheduler> scheduler,
+    std::chrono::milliseconds flushInterval)
     : m_eventManager{eventManager}
+    , m_scheduler{std::move(scheduler)}
+    , m_flushInterval{flushInterval}
+    , m_fileAttrSubscriptions{
+          std::bind(&FsSubscriptions::sendFileAttrSubscription, this, _1),
+          std::bind(&FsSubscriptions::sendSubscriptionCancellation, this, _1),
+          m_deferred}
+    , m_permissionChangedSubscriptions{
+          std::bind(
+              &FsSubscriptions::sendPermissionChangedSubscription, this, _1),
+          std::bind(&FsSubscriptions::sendSubscriptionCancellation, this, _1),
+          m_deferred}
+    , m_fileRemovalSubscriptions{
+          std::bind(&FsSubscriptions::sendFileRemovalSubscription, this, _1),
+          std::bind(&FsSubscriptions::sendSubscriptionCancellation, this, _1),
+          m_deferred}
+    , m_fileRenamedSubscriptions{
+          std::bind(&FsSubscriptions::sendFileRenamedSubscription, this, _1),
+          std::bind(&FsSubscriptions::sendSubscriptionCancellation, this, _1),
+          m_deferred}
+{
+    if (m_deferred) {
+        std::lock_guard<std::mutex> guard{m_cancelFlushMutex};
+        scheduleFlush();
+    }
+}
+
+FsSubscriptions::~FsSubscriptions()
 {
+    std::lock_guard<std::mutex> guard{m_cancelFlushMutex};
+    m_cancelFlush();
 }
 
 void FsSubscriptions::addFileLocationSubscription(const std::string &fileUuid)
@@ -44,67 +77,43 @@ void FsSubscriptions::removeFileLocationSubscription(
 void FsSubscriptions::addPermissionChangedSubscription(
     const std::string &fileUuid)
 {
-    typename decltype(m_permissionChangedSubscriptions)::accessor acc;
-    if (m_permissionChangedSubscriptions.insert(acc, fileUuid))
-        acc->second = sendPermissionChangedSubscription(fileUuid);
+    m_permissionChangedSubscriptions.add(fileUuid);
 }
 
 void FsSubscriptions::removePermissionChangedSubscription(
     const std::string &fileUuid)
 {
-    typename decltype(m_permissionChangedSubscriptions)::accessor acc;
-    if (m_permissionChangedSubscriptions.find(acc, fileUuid)) {
-        sendSubscriptionCancellation(acc->second);
-        m_permissionChangedSubscriptions.erase(acc);
-    }
+    m_permissionChangedSubscriptions.remove(fileUuid);
 }
 
 void FsSubscriptions::addFileRemovalSubscription(const std::string &fileUuid)
 {
-    typename decltype(m_fileRemovalSubscriptions)::accessor acc;
-    if (m_fileRemovalSubscriptions.insert(acc, fileUuid))
-        acc->second = sendFileRemovalSubscription(fileUuid);
+    m_fileRemovalSubscriptions.add(fileUuid);
 }
 
 void FsSubscriptions::removeFileRemovalSubscription(const std::string &fileUuid)
 {
-    typename decltype(m_fileRemovalSubscriptions)::accessor acc;
-    if (m_fileRemovalSubscriptions.find(acc, fileUuid)) {
-        sendSubscriptionCancellation(acc->second);
-        m_fileRemovalSubscriptions.erase(acc);
-    }
+    m_fileRemovalSubscriptions.remove(fileUuid);
 }
 
 void FsSubscriptions::addFileRenamedSubscription(const std::string &fileUuid)
 {
-    typename decltype(m_fileRenamedSubscriptions)::accessor acc;
-    if (m_fileRenamedSubscriptions.insert(acc, fileUuid))
-        acc->second = sendFileRenamedSubscription(fileUuid);
+    m_fileRenamedSubscriptions.add(fileUuid);
 }
 
 void FsSubscriptions::removeFileRenamedSubscription(const std::string &fileUuid)
 {
-    typename decltype(m_fileRenamedSubscriptions)::accessor acc;
-    if (m_fileRenamedSubscriptions.find(acc, fileUuid)) {
-        sendSubscriptionCancellation(acc->second);
-        m_fileRenamedSubscriptions.erase(acc);
-    }
+    m_fileRenamedSubscriptions.remove(fileUuid);
 }
 
 void FsSubscriptions::addFileAttrSubscription(const std::string &fileUuid)
 {
-    typename decltype(m_fileAttrSubscriptions)::accessor acc;
-    if (m_fileAttrSubscriptions.insert(acc, fileUuid))
-        acc->second = sendFileAttrSubscription(fileUuid);
+    m_fileAttrSubscriptions.add(fileUuid);
 }
 
 void FsSubscriptions::removeFileAttrSubscription(const std::string &fileUuid)
 {
-    typename decltype(m_fileAttrSubscriptions)::accessor acc;
-    if (m_fileAttrSubscriptions.find(acc, fileUuid)) {
-        sendSubscriptionCancellation(acc->second);
-        m_fileAttrSubscriptions.erase(acc);
-    }
+    m_fileAttrSubscriptions.remove(fileUuid);
 }
 
 void FsSubscriptions::addQuotaSubscription()
@@ -120,6 +129,25 @@ void FsSubscriptions::removeQuotaSubscription()
     }
 }
 
+void FsSubscriptions::flush()
+{
+    m_fileAttrSubscriptions.flush();
+    m_permissionChangedSubscriptions.flush();
+    m_fileRemovalSubscriptions.flush();
+    m_fileRenamedSubscriptions.flush();
+}
+
+void FsSubscriptions::scheduleFlush()
+{
+    // The flush is done under the lock, so that the destructor waits for the
+    // flush in progress before cancelling the next one
+    m_cancelFlush = m_scheduler->schedule(m_flushInterval, [this] {
+        std::lock_guard<std::mutex> guard{m_cancelFlushMutex};
+        flush();
+        scheduleFlush();
+    });
+}
+
 std::int64_t FsSubscriptions::sendFileAttrSubscription(
     const std::string &fileUuid)
 {
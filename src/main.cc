@@ -306,9 +306,11 @@ int main(int argc, char *argv[])
     }
 
     // FUSE main:
-    struct fuse *fuse;
+    struct fuse *fuse = nullptr;
+    struct fuse_session *session = nullptr;
     struct fuse_chan *ch;
     struct fuse_operations fuse_oper = fuseOperations();
+    struct fuse_lowlevel_ops fuse_ll_oper = fuseLowLevelOperations();
     char *mountpoint;
     int multithreaded;
     int foreground;
@@ -332,15 +334,33 @@ int main(int argc, char *argv[])
         perror("WARNING: failed to set FD_CLOEXEC on fuse device");
 
     FsLogicWrapper fsLogicWrapper;
-    fuse = fuse_new(ch, &args, &fuse_oper, sizeof(fuse_oper), &fsLogicWrapper);
-    if (fuse == nullptr)
-        return EXIT_FAILURE;
+    if (options->get_low_level_fuse()) {
+        session = fuse_lowlevel_new(
+            &args, &fuse_ll_oper, sizeof(fuse_ll_oper), &fsLogicWrapper);
+        if (session == nullptr)
+            return EXIT_FAILURE;
+
+        fuse_session_add_chan(session, ch);
+    }
+    else {
+        fuse = fuse_new(
+            ch, &args, &fuse_oper, sizeof(fuse_oper), &fsLogicWrapper);
+        if (fuse == nullptr)
+            return EXIT_FAILURE;
+
+        session = fuse_get_session(fuse);
+    }
 
-    ScopeExit destroyFuse{[&] { fuse_destroy(fuse); }, unmountFuse};
+    ScopeExit destroyFuse{[&] {
+                              if (fuse)
+                                  fuse_destroy(fuse);
+                              else
+                                  fuse_session_destroy(session);
+                          },
+        unmountFuse};
 
-    fuse_set_signal_handlers(fuse_get_session(fuse));
-    ScopeExit removeHandlers{
-        [&] { fuse_remove_signal_handlers(fuse_get_session(fuse)); }};
+    fuse_set_signal_handlers(session);
+    ScopeExit removeHandlers{[&] { fuse_remove_signal_handlers(session); }};
 
     std::cout << "oneclient has been successfully mounted in " << mountpoint
               << std::endl;
@@ -348,11 +368,11 @@ int main(int argc, char *argv[])
     if (!foreground) {
         context->scheduler()->prepareForDaemonize();
 
-        fuse_remove_signal_handlers(fuse_get_session(fuse));
+        fuse_remove_signal_handlers(session);
         res = fuse_daemonize(foreground);
 
         if (res != -1)
-            res = fuse_set_signal_handlers(fuse_get_session(fuse));
+            res = fuse_set_signal_handlers(session);
 
         if (res == -1)
             return EXIT_FAILURE;
@@ -371,8 +391,22 @@ int main(int argc, char *argv[])
     fsLogicWrapper.logic =
         std::make_unique<FsLogic>(std::move(context), std::move(configuration));
 
+    if (options->get_kernel_cache()) {
+        if (fuse)
+            std::cerr << "WARNING: kernel_cache requires low_level_fuse, "
+                         "kernel caching is disabled."
+                      << std::endl;
+        else
+            fsLogicWrapper.logic->enableKernelCache(
+                ch, options->get_kernel_cache_timeout());
+    }
+
     // Enter FUSE loop
-    res = multithreaded ? fuse_loop_mt(fuse) : fuse_loop(fuse);
+    if (fuse)
+        res = multithreaded ? fuse_loop_mt(fuse) : fuse_loop(fuse);
+    else
+        res = multithreaded ? fuse_session_loop_mt(session)
+                            : fuse_session_loop(session);
 
     communicator->stop();
     return res == -1 ? EXIT_FAILURE : EXIT_SUCCESS;
@@ -16,7 +16,7 @@ namespace one {
 namespace messages {
 
 Configuration::Configuration(
-    std::unique_ptr<ProtocolServerMessage> serverMessage)
+    ProtocolServerMessagePtr serverMessage)
 {
     auto configurationMsg = serverMessage->mutable_configuration();
     for (const auto &subscription : configurationMsg->subscriptions())
@@ -34,7 +34,7 @@ public:
      * @param serverMessage Protocol Buffers message representing @c
      * Configuration counterpart.
      */
-    Configuration(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    Configuration(ProtocolServerMessagePtr serverMessage);
 
     /**
      * @return subscription container.
@@ -17,7 +17,7 @@ namespace one {
 namespace messages {
 namespace fuse {
 
-Checksum::Checksum(std::unique_ptr<ProtocolServerMessage> serverMessage)
+Checksum::Checksum(ProtocolServerMessagePtr serverMessage)
 {
     Status{*serverMessage->mutable_fuse_response()->mutable_status()}
         .throwOnError();
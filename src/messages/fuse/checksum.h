@@ -34,7 +34,7 @@ public:
      * @param serverMessage Protocol Buffers message representing
      * @c ServerMessage.
      */
-    Checksum(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    Checksum(ProtocolServerMessagePtr serverMessage);
 
     /**
      * @return Checksum value.
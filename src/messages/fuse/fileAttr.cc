@@ -20,7 +20,7 @@ namespace one {
 namespace messages {
 namespace fuse {
 
-FileAttr::FileAttr(std::unique_ptr<ProtocolServerMessage> serverMessage)
+FileAttr::FileAttr(ProtocolServerMessagePtr serverMessage)
     : FuseResponse(serverMessage)
 {
     if (!serverMessage->fuse_response().has_file_attr())
@@ -47,7 +47,7 @@ public:
      * @param message Protocol Buffers message that wraps @c
      * one::clproto::FileAttr message.
      */
-    FileAttr(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    FileAttr(ProtocolServerMessagePtr serverMessage);
 
     /**
      * Constructor.
@@ -18,7 +18,7 @@ namespace one {
 namespace messages {
 namespace fuse {
 
-FileChildren::FileChildren(std::unique_ptr<ProtocolServerMessage> serverMessage)
+FileChildren::FileChildren(ProtocolServerMessagePtr serverMessage)
     : FuseResponse{serverMessage}
 {
     if (!serverMessage->fuse_response().has_file_children())
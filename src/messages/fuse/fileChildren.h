@@ -30,7 +30,7 @@ public:
      * @param serverMessage Protocol Buffers message representing
      * @c FileChildren counterpart.
      */
-    FileChildren(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    FileChildren(ProtocolServerMessagePtr serverMessage);
 
     /**
      * @return A list of directory's children, specified by their UUID and
@@ -19,7 +19,7 @@ namespace one {
 namespace messages {
 namespace fuse {
 
-FileLocation::FileLocation(std::unique_ptr<ProtocolServerMessage> serverMessage)
+FileLocation::FileLocation(ProtocolServerMessagePtr serverMessage)
     : FuseResponse{serverMessage}
 {
     if (!serverMessage->fuse_response().has_file_location())
@@ -49,13 +49,34 @@ const std::string &FileLocation::fileId() const { return m_fileId; }
 
 void FileLocation::fileId(std::string fileId_) { m_fileId.swap(fileId_); }
 
-FileLocation::FileBlocksMap &FileLocation::blocks() { return m_blocks; }
-
 const FileLocation::FileBlocksMap &FileLocation::blocks() const
+{
+    return *m_blocks;
+}
+
+FileLocation::FileBlocksMapPtr FileLocation::blocksSnapshot() const
 {
     return m_blocks;
 }
 
+void FileLocation::blocks(const FileLocation &fileLocation)
+{
+    m_blocks = fileLocation.m_blocks;
+}
+
+void FileLocation::putBlocks(const FileBlocksMap &blocks_)
+{
+    mutableBlocks() += blocks_;
+}
+
+void FileLocation::truncateBlocks(const off_t size)
+{
+    if (!m_blocks->empty() &&
+        boost::icl::last_next(m_blocks->rbegin()->first) > size)
+        mutableBlocks() &=
+            boost::icl::discrete_interval<off_t>::right_open(0, size);
+}
+
 const boost::optional<std::string> &FileLocation::handleId() const
 {
     return m_handleId;
@@ -81,7 +102,7 @@ std::string FileLocation::toString() const
     stream << "type: 'FileLocation', uuid: '" << m_uuid << "', storageId: '"
            << m_storageId << "', fileId: '" << m_fileId << "', blocks: [";
 
-    for (const auto &block : m_blocks)
+    for (const auto &block : *m_blocks)
         stream << block.first << " -> (" << block.second.storageId() << ", "
                << block.second.fileId() << "), ";
 
@@ -113,7 +134,7 @@ void FileLocation::deserialize(ProtocolMessage &message)
         else
             storageId_ = m_storageId;
 
-        m_blocks += std::make_pair(
+        *m_blocks += std::make_pair(
             interval, FileBlock{std::move(storageId_), std::move(fileId_)});
     }
 
@@ -122,6 +143,16 @@ void FileLocation::deserialize(ProtocolMessage &message)
     }
 }
 
+FileLocation::FileBlocksMap &FileLocation::mutableBlocks()
+{
+    // The caller has exclusive access to this location, so no other owner of
+    // the snapshot can appear while it is modified in place
+    if (m_blocks.use_count() > 1)
+        m_blocks = std::make_shared<FileBlocksMap>(*m_blocks);
+
+    return *m_blocks;
+}
+
 } // namespace fuse
 } // namespace messages
 } // namespace one
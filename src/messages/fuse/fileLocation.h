@@ -37,12 +37,16 @@ namespace fuse {
 /**
  * The @c FileLocation class represents server-sent information about file
  * location.
+ * The map of blocks is an immutable snapshot shared by copies of the
+ * location; a location modifying its blocks makes its own copy of the map
+ * first, unless it is the only owner of the snapshot.
  */
 class FileLocation : public FuseResponse {
 public:
     using Key = std::string;
     using FileBlocksMap = boost::icl::interval_map<off_t, FileBlock,
         boost::icl::partial_enricher>;
+    using FileBlocksMapPtr = std::shared_ptr<const FileBlocksMap>;
     using FileLocationPtr = std::unique_ptr<FileLocation>;
     using ProtocolMessage = clproto::FileLocation;
     using Subscription = client::events::FileLocationSubscription;
@@ -54,7 +58,7 @@ public:
      * @param message Protocol Buffers message that wraps @c
      * one::clproto::FileLocation message.
      */
-    FileLocation(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    FileLocation(ProtocolServerMessagePtr serverMessage);
 
     /**
      * Constructor.
@@ -102,16 +106,35 @@ public:
      */
     void fileId(std::string fileId);
 
-    /**
-      * @return Blocks per storageId/fileId pair.
-      */
-    FileBlocksMap &blocks();
-
     /**
      * @return Blocks per storageId/fileId pair.
      */
     const FileBlocksMap &blocks() const;
 
+    /**
+     * @return Snapshot of blocks, unaffected by later changes of the
+     * location.
+     */
+    FileBlocksMapPtr blocksSnapshot() const;
+
+    /**
+     * Shares blocks of another location.
+     * @param fileLocation The location whose blocks to set.
+     */
+    void blocks(const FileLocation &fileLocation);
+
+    /**
+     * Adds blocks, replacing existing blocks in their ranges.
+     * @param blocks The blocks to add.
+     */
+    void putBlocks(const FileBlocksMap &blocks);
+
+    /**
+     * Drops blocks beyond a given file size.
+     * @param size The size to truncate blocks to.
+     */
+    void truncateBlocks(const off_t size);
+
     /**
      * @return ID of file handle.
      */
@@ -140,12 +163,14 @@ public:
 
 private:
     void deserialize(ProtocolMessage &message);
+    FileBlocksMap &mutableBlocks();
 
     std::string m_uuid;
     std::string m_spaceId;
     std::string m_storageId;
     std::string m_fileId;
-    FileBlocksMap m_blocks;
+    std::shared_ptr<FileBlocksMap> m_blocks =
+        std::make_shared<FileBlocksMap>();
     boost::optional<std::string> m_handleId;
 };
 
@@ -17,7 +17,7 @@ namespace one {
 namespace messages {
 namespace fuse {
 
-FileRenamed::FileRenamed(std::unique_ptr<ProtocolServerMessage> serverMessage)
+FileRenamed::FileRenamed(ProtocolServerMessagePtr serverMessage)
     : FuseResponse{serverMessage}
 {
     if (!serverMessage->fuse_response().has_file_renamed())
@@ -34,7 +34,7 @@ public:
      * @param serverMessage Protocol Buffers message representing
      * @c FileRenamed counterpart
      */
-    FileRenamed(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    FileRenamed(ProtocolServerMessagePtr serverMessage);
 
     /**
      * @return New UUID of renamed file.
@@ -16,7 +16,7 @@ namespace messages {
 namespace fuse {
 
 FuseResponse::FuseResponse(
-    const std::unique_ptr<ProtocolServerMessage> &serverMessage)
+    const ProtocolServerMessagePtr &serverMessage)
 {
     if (!serverMessage->has_fuse_response())
         throw std::system_error{std::make_error_code(std::errc::protocol_error),
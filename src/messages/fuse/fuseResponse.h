@@ -33,7 +33,7 @@ public:
      * @note The constructor throws an applicable std::system_error exception if
      * received message's status is not OK.
      */
-    FuseResponse(const std::unique_ptr<ProtocolServerMessage> &serverMessage);
+    FuseResponse(const ProtocolServerMessagePtr &serverMessage);
 
     virtual std::string toString() const override;
 };
@@ -17,7 +17,7 @@ namespace one {
 namespace messages {
 namespace fuse {
 
-HelperParams::HelperParams(std::unique_ptr<ProtocolServerMessage> serverMessage)
+HelperParams::HelperParams(ProtocolServerMessagePtr serverMessage)
     : FuseResponse(serverMessage)
 {
     if (!serverMessage->fuse_response().has_helper_params())
@@ -37,7 +37,7 @@ public:
      * @param serverMessage Protocol Buffers message representing
      * @c ServerMessage.
      */
-    HelperParams(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    HelperParams(ProtocolServerMessagePtr serverMessage);
 
     /**
      * Constructor.
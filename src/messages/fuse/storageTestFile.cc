@@ -17,7 +17,7 @@ namespace messages {
 namespace fuse {
 
 StorageTestFile::StorageTestFile(
-    std::unique_ptr<ProtocolServerMessage> serverMessage)
+    ProtocolServerMessagePtr serverMessage)
 {
     if (!serverMessage->fuse_response().has_storage_test_file())
         throw std::system_error{std::make_error_code(std::errc::protocol_error),
@@ -36,7 +36,7 @@ public:
      * @param serverMessage Protocol Buffers message representing
      * @c ServerMessage.
      */
-    StorageTestFile(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    StorageTestFile(ProtocolServerMessagePtr serverMessage);
 
     /**
      * @return Storage helper parameters used to access test file.
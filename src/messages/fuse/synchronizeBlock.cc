@@ -15,10 +15,11 @@ namespace one {
 namespace messages {
 namespace fuse {
 
-SynchronizeBlock::SynchronizeBlock(
-    std::string uuid, boost::icl::discrete_interval<off_t> block)
+SynchronizeBlock::SynchronizeBlock(std::string uuid,
+    boost::icl::discrete_interval<off_t> block, const bool prefetch)
     : FileRequest{std::move(uuid)}
     , m_block{block}
+    , m_prefetch{prefetch}
 {
 }
 
@@ -26,7 +27,7 @@ std::string SynchronizeBlock::toString() const
 {
     std::stringstream stream;
     stream << "type: 'SynchronizeBlock', uuid: " << m_contextGuid
-           << ", block: " << m_block;
+           << ", block: " << m_block << ", prefetch: " << m_prefetch;
     return stream.str();
 }
 
@@ -39,6 +40,7 @@ std::unique_ptr<ProtocolClientMessage> SynchronizeBlock::serializeAndDestroy()
 
     sb->mutable_block()->set_offset(boost::icl::first(m_block));
     sb->mutable_block()->set_size(boost::icl::size(m_block));
+    sb->set_prefetch(m_prefetch);
 
     return msg;
 }
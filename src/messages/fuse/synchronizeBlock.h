@@ -31,9 +31,11 @@ public:
      * Constructor.
      * @param uuid UUID of the file to synchronize.
      * @param block interval that should be synchronized.
+     * @param prefetch Whether the synchronization is a prefetch, i.e. no
+     * reader is waiting for the block.
      */
-    SynchronizeBlock(
-        std::string uuid, boost::icl::discrete_interval<off_t> block);
+    SynchronizeBlock(std::string uuid,
+        boost::icl::discrete_interval<off_t> block, const bool prefetch);
 
     std::string toString() const override;
 
@@ -41,6 +43,7 @@ private:
     std::unique_ptr<ProtocolClientMessage> serializeAndDestroy() override;
 
     boost::icl::discrete_interval<off_t> m_block;
+    bool m_prefetch;
 };
 
 } // namespace fuse
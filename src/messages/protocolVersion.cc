@@ -16,7 +16,7 @@ namespace one {
 namespace messages {
 
 ProtocolVersion::ProtocolVersion(
-    std::unique_ptr<ProtocolServerMessage> serverMessage)
+    ProtocolServerMessagePtr serverMessage)
 {
     auto &protocolVersionMsg = serverMessage->protocol_version();
     m_major = protocolVersionMsg.major();
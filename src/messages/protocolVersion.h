@@ -28,7 +28,7 @@ public:
      * @param serverMessage Protocol Buffers message representing @c
      * ProtocolVersion counterpart.
      */
-    ProtocolVersion(std::unique_ptr<ProtocolServerMessage> serverMessage);
+    ProtocolVersion(ProtocolServerMessagePtr serverMessage);
 
     /**
      * @return Communication protocol major version.
@@ -57,13 +57,28 @@ void Options::setDescriptions()
     add_log_dir(m_common);
     add_fuse_id(m_common);
     add_jobscheduler_threads(m_common);
+    add_io_threads(m_common);
+    add_event_threads(m_common);
+    add_write_event_max_blocks(m_common);
+    add_write_event_coalesce_blocks(m_common);
+    add_write_event_coalesce_gap(m_common);
+    add_event_stream_buffer_max_size(m_common);
+    add_subscriptions_flush_interval(m_common);
     add_enable_dir_prefetch(m_common);
     add_enable_parallel_getattr(m_common);
+    add_dir_cache_max_entries(m_common);
+    add_negative_cache_max_entries(m_common);
+    add_metadata_cache_max_entries(m_common);
+    add_metadata_cache_max_size(m_common);
+    add_metadata_cache_file(m_common);
     add_enable_permission_checking(m_common);
     add_enable_location_cache(m_common);
     add_global_registry_url(m_common);
     add_global_registry_port(m_common);
     add_authentication(m_common);
+    add_low_level_fuse(m_common);
+    add_kernel_cache(m_common);
+    add_kernel_cache_timeout(m_common);
 
     // Restricted options exclusive to global config file
     add_enable_env_option_override(m_restricted);
@@ -76,6 +91,8 @@ void Options::setDescriptions()
     add_read_buffer_max_file_size(m_restricted);
     add_file_buffer_prefered_block_size(m_restricted);
     add_file_sync_timeout(m_restricted);
+    add_sync_ahead_min_size(m_restricted);
+    add_sync_ahead_max_size(m_restricted);
 
     // General commandline options
     add_switch_help(m_commandline);
@@ -86,6 +103,8 @@ void Options::setDescriptions()
     add_switch_debug_gsi(m_commandline);
     add_switch_no_check_certificate(m_commandline);
     add_switch_proxyio(m_commandline);
+    add_switch_low_level_fuse(m_commandline);
+    add_switch_kernel_cache(m_commandline);
 
     // FUSE-specific commandline options
     m_fuse.add_options()(",o",
@@ -0,0 +1,469 @@
+/**
+ * @file events_benchmark.cc
+ * @author Krzysztof Trzepla
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "events/aggregators/eventCounterAggregator.h"
+#include "events/aggregators/eventSizeAggregator.h"
+#include "events/aggregators/eventTimeAggregator.h"
+#include "events/buffers/threadLocalEventBuffer.h"
+#include "events/eventHandler.h"
+#include "events/eventWorker.h"
+#include "events/subscriptionHandler.h"
+#include "events/subscriptions/fileAccessedSubscription.h"
+#include "events/subscriptions/readSubscription.h"
+#include "events/subscriptions/subscriptionCancellation.h"
+#include "events/subscriptions/writeSubscription.h"
+#include "events/types/fileAccessedEvent.h"
+#include "events/types/readEvent.h"
+#include "events/types/writeEvent.h"
+#include "messages.pb.h"
+#include "scheduler.h"
+
+#include <asio/executor_work.hpp>
+#include <asio/io_service.hpp>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace one;
+using namespace one::client::events;
+using namespace std::chrono_literals;
+
+namespace {
+std::atomic<std::size_t> allocations{0};
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr = std::malloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc{};
+}
+
+// Deallocation is kept out of line, as otherwise the compiler would report
+// memory allocated with the replaced operator new as released with free.
+__attribute__((noinline)) void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(
+    void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace {
+
+/// Number of distinct synthetic events emitted in a cycle by each benchmark.
+constexpr std::size_t EVENTS_CYCLE = 1 << 16;
+
+/// Number of emit latency samples kept by latency benchmarks.
+constexpr std::size_t LATENCY_SAMPLES = 1 << 20;
+
+/// Number of events emitted to an event stream before waiting for it to drain.
+constexpr std::size_t EMIT_BATCH = 1 << 10;
+
+/// Distribution of file UUIDs among emitted events.
+enum class Distribution {
+    /// Every file is equally likely to be accessed.
+    uniform,
+    /// 90% of events concern 10% of files.
+    skewed
+};
+
+/**
+ * @c NullCommunicator replaces @c EventCommunicator at the bottom of the
+ * benchmarked event streams. It counts and discards everything it is given.
+ */
+template <class EventType> class NullCommunicator {
+public:
+    using EventT = EventType;
+    using EventPtr = typename EventT::EventPtr;
+    using Subscription = typename EventT::Subscription;
+    using SubscriptionPtr = std::unique_ptr<Subscription>;
+
+    NullCommunicator<EventT> &communicator = *this;
+
+    virtual ~NullCommunicator() = default;
+
+    void send(std::vector<EventPtr> &&events)
+    {
+        m_sent.fetch_add(events.size(), std::memory_order_relaxed);
+    }
+
+    void send(Subscription &&) {}
+
+    void send(SubscriptionCancellation &&) {}
+
+    void setDeferredFlushHandler(std::function<void(std::function<void()>)>)
+    {
+    }
+
+    std::size_t sent() const { return m_sent; }
+
+private:
+    std::atomic<std::size_t> m_sent{0};
+};
+
+/**
+ * The layers of the event streams defined in @c eventStream.h on top of a
+ * @c NullCommunicator, from the bottom one up to the full aggregation stack.
+ */
+template <class EventT>
+using HandlerStack = SubscriptionHandler<EventHandler<NullCommunicator<EventT>>>;
+
+template <class EventT>
+using TimeStack = EventTimeAggregator<HandlerStack<EventT>>;
+
+template <class EventT>
+using SizeStack = EventSizeAggregator<TimeStack<EventT>>;
+
+template <class EventT>
+using ReadWriteStack = EventCounterAggregator<SizeStack<EventT>>;
+
+using FileAccessedStack =
+    EventCounterAggregator<TimeStack<FileAccessedEvent>>;
+
+template <class EventT> struct StackTraits;
+
+template <> struct StackTraits<ReadEvent> {
+    using Stack = ReadWriteStack<ReadEvent>;
+
+    static ReadSubscription subscription()
+    {
+        return ReadSubscription{1, 10000, 500ms, 10 * 1024 * 1024};
+    }
+
+    static ReadEvent::EventPtr event(const std::string &uuid, std::size_t i)
+    {
+        return std::make_unique<ReadEvent>(i * 4096, 4096, uuid);
+    }
+};
+
+template <> struct StackTraits<WriteEvent> {
+    using Stack = ReadWriteStack<WriteEvent>;
+
+    static WriteSubscription subscription()
+    {
+        return WriteSubscription{1, 10000, 500ms, 10 * 1024 * 1024};
+    }
+
+    static WriteEvent::EventPtr event(const std::string &uuid, std::size_t i)
+    {
+        return std::make_unique<WriteEvent>(i * 4096, 4096, uuid);
+    }
+};
+
+template <> struct StackTraits<FileAccessedEvent> {
+    using Stack = FileAccessedStack;
+
+    static FileAccessedSubscription subscription()
+    {
+        return FileAccessedSubscription{1, 1000, 500ms};
+    }
+
+    static FileAccessedEvent::EventPtr event(
+        const std::string &uuid, std::size_t)
+    {
+        return std::make_unique<FileAccessedEvent>(uuid, 1, 0);
+    }
+};
+
+/**
+ * @return Distribution of file UUIDs selected by a benchmark's second argument.
+ */
+Distribution selectedDistribution(const benchmark::State &state)
+{
+    return static_cast<Distribution>(state.range(1));
+}
+
+/**
+ * Generates UUIDs of files accessed by consecutive events.
+ */
+std::vector<std::string> fileUuids(std::size_t files, Distribution distribution)
+{
+    std::mt19937 generator{0};
+    std::uniform_int_distribution<std::size_t> any{0, files - 1};
+    std::uniform_int_distribution<std::size_t> hot{
+        0, std::max<std::size_t>(files / 10, 1) - 1};
+    std::bernoulli_distribution isHot{0.9};
+
+    std::vector<std::string> uuids;
+    uuids.reserve(EVENTS_CYCLE);
+    for (std::size_t i = 0; i < EVENTS_CYCLE; ++i) {
+        auto file = distribution == Distribution::skewed && isHot(generator)
+            ? hot(generator)
+            : any(generator);
+        uuids.emplace_back("fileUuid" + std::to_string(file));
+    }
+
+    return uuids;
+}
+
+/**
+ * Reports throughput and allocations per event of a benchmark run.
+ */
+void report(benchmark::State &state, std::size_t allocationsBefore,
+    std::size_t eventsPerIteration = 1)
+{
+    // Allocations are counted globally, so they are related to the events
+    // emitted by all threads and averaged over the threads.
+    auto events = state.iterations() * eventsPerIteration * state.threads();
+    state.SetItemsProcessed(state.iterations() * eventsPerIteration);
+    state.counters["allocs/event"] =
+        benchmark::Counter(static_cast<double>(allocations - allocationsBefore) /
+                std::max<decltype(events)>(events, 1),
+            benchmark::Counter::kAvgThreads);
+}
+
+/**
+ * Reports percentiles of emit latency sampled by a benchmark run.
+ */
+void reportLatency(benchmark::State &state, std::vector<double> &samples)
+{
+    if (samples.empty())
+        return;
+
+    auto percentile = [&](double p) {
+        auto nth = samples.begin() +
+            static_cast<std::ptrdiff_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), nth, samples.end());
+        return *nth;
+    };
+
+    state.counters["p50_ns"] =
+        benchmark::Counter(percentile(0.5), benchmark::Counter::kAvgThreads);
+    state.counters["p99_ns"] =
+        benchmark::Counter(percentile(0.99), benchmark::Counter::kAvgThreads);
+    state.counters["p999_ns"] =
+        benchmark::Counter(percentile(0.999), benchmark::Counter::kAvgThreads);
+}
+
+template <class EventT>
+void initializeStack(HandlerStack<EventT> &stack, std::shared_ptr<Scheduler>)
+{
+    stack.setEventHandler([&stack](auto events) {
+        stack.communicator.send(std::move(events));
+    });
+}
+
+template <class Stack>
+void initializeStack(Stack &stack, std::shared_ptr<Scheduler> scheduler)
+{
+    stack.setScheduler(std::move(scheduler));
+    stack.setEventHandler([&stack](auto events) {
+        stack.communicator.send(std::move(events));
+    });
+    stack.initializeAggregation();
+}
+
+template <class Stack, class Subscription>
+void subscribeStack(Stack &stack, Subscription subscription)
+{
+    stack.subscribe(std::make_unique<Subscription>(std::move(subscription)));
+}
+
+/**
+ * Measures synchronous processing of events by a stack of layers.
+ */
+template <class EventT, template <class> class Stack>
+void processEvents(benchmark::State &state)
+{
+    auto uuids = fileUuids(state.range(0), selectedDistribution(state));
+    auto scheduler = std::make_shared<Scheduler>(1);
+
+    Stack<EventT> stack;
+    initializeStack(stack, scheduler);
+    subscribeStack(stack, StackTraits<EventT>::subscription());
+
+    std::size_t i = 0;
+    auto allocationsBefore = allocations.load();
+    for (auto _ : state) {
+        stack.process(
+            StackTraits<EventT>::event(uuids[i % EVENTS_CYCLE], i));
+        ++i;
+    }
+    report(state, allocationsBefore);
+}
+
+/**
+ * Measures emission of events to a full event stream running on a shared IO
+ * service, as done by @c EventManager for events of a single type.
+ */
+template <class EventT>
+void emitEvents(benchmark::State &state)
+{
+    using Stream = EventWorker<typename StackTraits<EventT>::Stack>;
+
+    auto uuids = fileUuids(state.range(0), selectedDistribution(state));
+    auto scheduler = std::make_shared<Scheduler>(1);
+    auto registry = std::make_shared<SubscriptionRegistry>();
+
+    asio::io_service ioService;
+    auto idleWork = asio::make_work(ioService);
+    std::thread worker{[&] { ioService.run(); }};
+
+    std::vector<double> samples;
+    samples.reserve(LATENCY_SAMPLES);
+
+    {
+        Stream stream{ioService};
+        initializeStack(stream, scheduler);
+        stream.setSubscriptionRegistry(registry);
+        stream.subscribe(StackTraits<EventT>::subscription());
+
+        std::size_t i = 0;
+        auto allocationsBefore = allocations.load();
+        for (auto _ : state) {
+            for (std::size_t j = 0; j < EMIT_BATCH; ++j, ++i) {
+                auto event =
+                    StackTraits<EventT>::event(uuids[i % EVENTS_CYCLE], i);
+                auto start = std::chrono::steady_clock::now();
+                stream.emitEvent(std::move(event));
+                auto stop = std::chrono::steady_clock::now();
+                if (samples.size() < LATENCY_SAMPLES)
+                    samples.emplace_back(
+                        std::chrono::duration<double, std::nano>{stop - start}
+                            .count());
+            }
+            // Emitting only posts the events, so the batch is measured until
+            // the stream has processed it.
+            stream.flush();
+        }
+        report(state, allocationsBefore, EMIT_BATCH);
+    }
+
+    ioService.stop();
+    worker.join();
+    reportLatency(state, samples);
+}
+
+/**
+ * Measures emission of events pre-aggregated in the emitting threads before
+ * reaching a full event stream, as done by @c EventManager for read and write
+ * events.
+ */
+template <class EventT>
+void emitLocallyAggregatedEvents(benchmark::State &state)
+{
+    using Stream = EventWorker<typename StackTraits<EventT>::Stack>;
+
+    static asio::io_service ioService;
+    static std::unique_ptr<Stream> stream;
+    static std::unique_ptr<ThreadLocalEventBuffer<EventT>> localEvents;
+    static std::unique_ptr<std::thread> worker;
+    static std::shared_ptr<Scheduler> scheduler;
+
+    if (state.thread_index() == 0) {
+        ioService.reset();
+        scheduler = std::make_shared<Scheduler>(1);
+        worker = std::make_unique<std::thread>([] {
+            auto idleWork = asio::make_work(ioService);
+            ioService.run();
+        });
+        stream = std::make_unique<Stream>(ioService);
+        initializeStack(*stream, scheduler);
+        stream->setSubscriptionRegistry(
+            std::make_shared<SubscriptionRegistry>());
+        stream->subscribe(StackTraits<EventT>::subscription());
+        localEvents = std::make_unique<ThreadLocalEventBuffer<EventT>>(64,
+            [](auto event) { stream->emitEvent(std::move(event)); });
+    }
+
+    auto uuids = fileUuids(state.range(0), selectedDistribution(state));
+    std::vector<double> samples;
+    samples.reserve(LATENCY_SAMPLES);
+
+    std::size_t i = state.thread_index() * EVENTS_CYCLE;
+    auto allocationsBefore = allocations.load();
+    for (auto _ : state) {
+        for (std::size_t j = 0; j < EMIT_BATCH; ++j, ++i) {
+            auto event = StackTraits<EventT>::event(uuids[i % EVENTS_CYCLE], i);
+            auto start = std::chrono::steady_clock::now();
+            localEvents->push(std::move(event));
+            auto stop = std::chrono::steady_clock::now();
+            if (samples.size() < LATENCY_SAMPLES)
+                samples.emplace_back(
+                    std::chrono::duration<double, std::nano>{stop - start}
+                        .count());
+        }
+        // Events handed over by the local buffers are only posted, so the
+        // batch is measured until the stream has processed them.
+        stream->flush();
+    }
+    report(state, allocationsBefore, EMIT_BATCH);
+    reportLatency(state, samples);
+
+    if (state.thread_index() == 0) {
+        localEvents.reset();
+        stream.reset();
+        ioService.stop();
+        worker->join();
+        worker.reset();
+        scheduler.reset();
+    }
+}
+
+void uniformFiles(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->ArgNames({"files", "distribution"});
+    for (auto files : {1, 1000, 100000})
+        benchmark->Args({files, static_cast<int>(Distribution::uniform)});
+}
+
+void allFiles(benchmark::internal::Benchmark *benchmark)
+{
+    uniformFiles(benchmark);
+    for (auto files : {1000, 100000})
+        benchmark->Args({files, static_cast<int>(Distribution::skewed)});
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(processEvents, ReadEvent, HandlerStack)->Apply(uniformFiles);
+BENCHMARK_TEMPLATE(processEvents, ReadEvent, TimeStack)->Apply(uniformFiles);
+BENCHMARK_TEMPLATE(processEvents, ReadEvent, SizeStack)->Apply(uniformFiles);
+BENCHMARK_TEMPLATE(processEvents, ReadEvent, ReadWriteStack)
+    ->Apply(uniformFiles);
+BENCHMARK_TEMPLATE(processEvents, WriteEvent, HandlerStack)
+    ->Apply(uniformFiles);
+BENCHMARK_TEMPLATE(processEvents, WriteEvent, TimeStack)->Apply(uniformFiles);
+BENCHMARK_TEMPLATE(processEvents, WriteEvent, SizeStack)->Apply(uniformFiles);
+BENCHMARK_TEMPLATE(processEvents, WriteEvent, ReadWriteStack)
+    ->Apply(uniformFiles);
+BENCHMARK_TEMPLATE(processEvents, FileAccessedEvent, HandlerStack)
+    ->Apply(uniformFiles);
+BENCHMARK_TEMPLATE(processEvents, FileAccessedEvent, TimeStack)
+    ->Apply(uniformFiles);
+
+BENCHMARK_TEMPLATE(emitEvents, ReadEvent)->Apply(allFiles);
+BENCHMARK_TEMPLATE(emitEvents, WriteEvent)->Apply(allFiles);
+BENCHMARK_TEMPLATE(emitEvents, FileAccessedEvent)->Apply(allFiles);
+
+BENCHMARK_TEMPLATE(emitLocallyAggregatedEvents, ReadEvent)
+    ->Apply(allFiles)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(emitLocallyAggregatedEvents, WriteEvent)
+    ->Apply(allFiles)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -58,14 +58,14 @@ public:
 
     std::uint64_t emitReadEvent(off_t offset, size_t size, std::string fileUuid)
     {
-        m_manager->emitReadEvent(offset, size, std::move(fileUuid));
+        m_manager->emitReadEvent(offset, size, fileUuid);
         return m_readEventStreamSequenceNumber++;
     }
 
     std::uint64_t emitWriteEvent(
         off_t offset, size_t size, std::string fileUuid)
     {
-        m_manager->emitWriteEvent(offset, size, std::move(fileUuid), {}, {});
+        m_manager->emitWriteEvent(offset, size, fileUuid, {}, {});
         return m_writeEventStreamSequenceNumber++;
     }
 
@@ -239,6 +239,40 @@ def test_getattrs_should_pass_errors(endpoint, fl):
     assert 'No such file or directory' in str(excinfo.value)
 
 
+def test_getattrs_should_cache_missing_paths(endpoint, fl):
+    response = messages_pb2.ServerMessage()
+    response.fuse_response.status.code = common_messages_pb2.Status.enoent
+
+    stat = fslogic.Stat()
+    with pytest.raises(RuntimeError):
+        with reply(endpoint, response):
+            fl.getattr('/random/path', stat)
+
+    with pytest.raises(RuntimeError) as excinfo:
+        fl.getattr('/random/path', stat)
+
+    assert 'No such file or directory' in str(excinfo.value)
+
+
+def test_mknod_should_forget_missing_path(endpoint, fl):
+    response = messages_pb2.ServerMessage()
+    response.fuse_response.status.code = common_messages_pb2.Status.enoent
+
+    stat = fslogic.Stat()
+    with pytest.raises(RuntimeError):
+        with reply(endpoint, response):
+            fl.getattr('/random/path', stat)
+
+    getattr_response = prepare_getattr('random', fuse_messages_pb2.DIR)
+    location_response = prepare_location()
+
+    with reply(endpoint, [getattr_response, location_response]):
+        assert 0 == fl.mknod('/random/path', 0762, 0)
+
+    with reply(endpoint, prepare_getattr('path', fuse_messages_pb2.REG)):
+        assert 0 == fl.getattr('/random/path', stat)
+
+
 def test_getattrs_should_cache_attrs(endpoint, fl):
     fuse_response = prepare_getattr('path', fuse_messages_pb2.REG)
 
@@ -252,6 +286,35 @@ def test_getattrs_should_cache_attrs(endpoint, fl):
     assert 3 == endpoint.all_messages_count()
 
 
+def test_getattrs_should_send_subscriptions_once(endpoint, fl):
+    fuse_response = prepare_getattr('path', fuse_messages_pb2.REG)
+
+    stat = fslogic.Stat()
+    with reply(endpoint, fuse_response):
+        assert 0 == fl.getattr('/random/path', stat)
+
+    for _ in range(10):
+        assert 0 == fl.getattr('/random/path', stat)
+
+    subscriptions = []
+    for received_msg in endpoint.wait_for_any_messages(msg_count=3,
+                                                       return_history=True):
+        client_message = messages_pb2.ClientMessage()
+        client_message.ParseFromString(received_msg)
+        assert client_message.HasField('subscription')
+        subscriptions.append(client_message.subscription)
+
+    assert sorted(s.WhichOneof('object') for s in subscriptions) == \
+           ['file_attr_subscription', 'file_removal_subscription',
+            'file_renamed_subscription']
+    for subscription in subscriptions:
+        subscribed = getattr(subscription, subscription.WhichOneof('object'))
+        assert subscribed.file_uuid == 'uuid1'
+
+    time.sleep(0.5)
+    assert 3 == endpoint.all_messages_count()
+
+
 def test_mkdir_should_mkdir(endpoint, fl):
     getattr_response = prepare_getattr('random', fuse_messages_pb2.DIR)
     response = messages_pb2.ServerMessage()
@@ -394,6 +457,26 @@ def test_rename_should_change_caches(appmock_client, endpoint, fl):
     assert 'No such file or directory' in str(excinfo.value)
 
 
+def test_rename_should_keep_cached_children_of_renamed_directory(endpoint,
+                                                                fl):
+    dir_response = prepare_getattr('dir', fuse_messages_pb2.DIR)
+    file_response = prepare_getattr('file', fuse_messages_pb2.REG)
+    file_response.fuse_response.file_attr.uuid = 'uuid3'
+    rename_response = prepare_rename()
+    rename_response.fuse_response.file_renamed.new_uuid = 'uuid1'
+
+    stat = fslogic.Stat()
+    with reply(endpoint, [dir_response, file_response]):
+        fl.getattr('/random/dir', stat)
+        fl.getattr('/random/dir/file', stat)
+
+    with reply(endpoint, rename_response):
+        fl.rename('/random/dir', '/random/dir2')
+
+    fl.getattr('/random/dir2/file', stat)
+    assert stat.size == file_response.fuse_response.file_attr.size
+
+
 def test_rename_should_pass_getattr_errors(endpoint, fl):
     response = messages_pb2.ServerMessage()
     response.fuse_response.status.code = common_messages_pb2.Status.enoent
@@ -776,7 +859,7 @@ def test_write_should_write(endpoint, fl):
 
 def test_write_should_partition_writes(endpoint, fl):
     do_open(endpoint, fl, blocks=[(0, 5)], size=5)
-    assert 5 == fl.write('/random/path', 0, 11)
+    assert 11 == fl.write('/random/path', 0, 11)
     assert 6 == fl.write('/random/path', 5, 6)
 
 
@@ -872,6 +955,101 @@ def test_readdir_big_directory(endpoint, fl):
     assert len(children) == children_num + 2
 
 
+def prepare_children(names, offset=0):
+    repl = fuse_messages_pb2.FileChildren()
+    for i, name in enumerate(names):
+        link = repl.child_links.add()
+        link.uuid = "child{0}".format(offset + i)
+        link.name = name
+
+    response = messages_pb2.ServerMessage()
+    response.fuse_response.file_children.CopyFrom(repl)
+    response.fuse_response.status.code = common_messages_pb2.Status.ok
+
+    return response
+
+
+def test_readdir_should_request_pages_ahead(endpoint, fl):
+    getattr_response = prepare_getattr('path', fuse_messages_pb2.DIR)
+    first_page = prepare_children(
+        ["file{0}".format(i) for i in xrange(0, 1000)])
+    last_page = prepare_children(['file1000', 'file1001'], offset=1000)
+
+    children = []
+    with reply(endpoint, [getattr_response, first_page, last_page]) as queue:
+        assert 0 == fl.readdir('/random/path', children)
+        queue.get()
+        first_request = queue.get()
+        second_request = queue.get()
+
+    assert len(children) == 1004
+    assert 'file1001' in children
+
+    offsets = [r.fuse_request.file_request.get_file_children.offset
+               for r in [first_request, second_request]]
+    assert offsets == [0, 1000]
+
+
+def test_getattr_should_prefetch_attrs_of_listed_children(endpoint, fl):
+    getattr_response = prepare_getattr('path', fuse_messages_pb2.DIR)
+    children_response = prepare_children(['file1', 'file2'])
+
+    children = []
+    with reply(endpoint, [getattr_response, children_response]):
+        assert 0 == fl.readdir('/random/path', children)
+
+    child_responses = []
+    for uuid in ['child0', 'child1']:
+        response = prepare_getattr(uuid, fuse_messages_pb2.REG)
+        response.fuse_response.file_attr.uuid = uuid
+        child_responses.append(response)
+
+    stat = fslogic.Stat()
+    with reply(endpoint, child_responses) as queue:
+        assert 0 == fl.getattr('/random/path/file1', stat)
+        queue.get()
+        client_message = queue.get()
+
+    file_request = client_message.fuse_request.file_request
+    assert file_request.HasField('get_file_attr')
+    assert file_request.context_guid == 'child1'
+
+
+def test_readdir_should_cache_listing(endpoint, fl):
+    getattr_response = prepare_getattr('path', fuse_messages_pb2.DIR)
+    children_response = prepare_children(['file1', 'file2'])
+
+    children = []
+    with reply(endpoint, [getattr_response, children_response]):
+        assert 0 == fl.readdir('/random/path', children)
+
+    cached_children = []
+    assert 0 == fl.readdir('/random/path', cached_children)
+    assert children == cached_children
+
+
+def test_unlink_should_update_cached_listing(endpoint, fl):
+    getattr_response = prepare_getattr('path', fuse_messages_pb2.DIR)
+    children_response = prepare_children(['file1', 'file2'])
+
+    children = []
+    with reply(endpoint, [getattr_response, children_response]):
+        assert 0 == fl.readdir('/random/path', children)
+
+    child_response = prepare_getattr('file1', fuse_messages_pb2.REG)
+    child_response.fuse_response.file_attr.uuid = 'child0'
+
+    ok_response = messages_pb2.ServerMessage()
+    ok_response.fuse_response.status.code = common_messages_pb2.Status.ok
+
+    with reply(endpoint, [child_response, ok_response]):
+        assert 0 == fl.unlink('/random/path/file1')
+
+    children = []
+    assert 0 == fl.readdir('/random/path', children)
+    assert sorted(children) == ['.', '..', 'file2']
+
+
 def test_write_should_save_blocks(endpoint, fl):
     do_open(endpoint, fl, size=0)
     assert 5 == fl.write('/random/path', 0, 5)
@@ -920,6 +1098,28 @@ def test_read_should_continue_reading_after_synchronization(appmock_client, endp
         assert 5 == fl.read('/random/path', 2, 5)
 
 
+def test_read_should_sync_ahead_of_sequential_reader(endpoint, fl):
+    do_open(endpoint, fl, blocks=[(0, 10)], size=100)
+    assert 5 == fl.read('/random/path', 0, 5)
+
+    response = messages_pb2.ServerMessage()
+    response.fuse_response.status.code = common_messages_pb2.Status.ok
+
+    with reply(endpoint, response) as queue:
+        assert 5 == fl.read('/random/path', 5, 5)
+        client_message = queue.get()
+
+    assert client_message.HasField('fuse_request')
+    assert client_message.fuse_request.HasField('file_request')
+    file_request = client_message.fuse_request.file_request
+    assert file_request.HasField('synchronize_block')
+    sync = file_request.synchronize_block
+    assert sync.block.offset == 10
+    assert sync.block.size == 90
+    assert sync.prefetch
+    assert file_request.context_guid == 'uuid1'
+
+
 def test_read_should_should_open_file_block_once(endpoint, fl):
     do_open(endpoint, fl, blocks=[(0, 5, 'storage1', 'file1'),
                                        (5, 5, 'storage2', 'file2')], size=10)
@@ -939,6 +1139,26 @@ def test_read_should_should_open_file_block_once(endpoint, fl):
     assert fl.verify_and_clear_expectations()
 
 
+def test_read_should_read_across_blocks(endpoint, fl):
+    do_open(endpoint, fl, blocks=[(0, 5, 'storage1', 'file1'),
+                                       (5, 5, 'storage2', 'file2')], size=10)
+
+    fl.expect_call_sh_open("file1", 1)
+    fl.expect_call_sh_open("file2", 1)
+
+    assert 10 == fl.read('/random/path', 0, 10)
+    assert 7 == fl.read('/random/path', 3, 7)
+
+    assert fl.verify_and_clear_expectations()
+
+
+def test_read_should_stop_at_missing_block(endpoint, fl):
+    do_open(endpoint, fl, blocks=[(0, 5, 'storage1', 'file1'),
+                                       (7, 3, 'storage2', 'file2')], size=10)
+
+    assert 5 == fl.read('/random/path', 0, 10)
+
+
 def test_write_should_should_open_file_block_once(endpoint, fl):
     do_open(endpoint, fl, blocks=[(0, 5, 'storage1', 'file1'),
                                        (5, 5, 'storage2', 'file2')], size=10)
@@ -958,6 +1178,19 @@ def test_write_should_should_open_file_block_once(endpoint, fl):
     assert fl.verify_and_clear_expectations()
 
 
+def test_write_should_write_across_blocks(endpoint, fl):
+    do_open(endpoint, fl, blocks=[(0, 5, 'storage1', 'file1'),
+                                       (5, 5, 'storage2', 'file2')], size=10)
+
+    fl.expect_call_sh_open("file1", 1)
+    fl.expect_call_sh_open("file2", 1)
+
+    assert 10 == fl.write('/random/path', 0, 10)
+    assert 7 == fl.write('/random/path', 3, 7)
+
+    assert fl.verify_and_clear_expectations()
+
+
 def test_release_should_release_open_file_blocks(endpoint, fl):
     do_open(endpoint, fl, blocks=[(0, 5, 'storage1', 'file1'),
                                        (5, 5, 'storage2', 'file2')], size=10)
@@ -256,3 +256,142 @@ TEST_F(CacheExpirationHelperTest, shouldAllowRescuingAnEntryAfterExpire)
     expirationHelper.tick(purge);
     ASSERT_TRUE(purgeCalled);
 }
+
+TEST_F(CacheExpirationHelperTest, shouldNotPurgeForgottenEntry)
+{
+    one::client::CacheExpirationHelper<int, 2> expirationHelper;
+
+    expirationHelper.markInteresting(key, [] {});
+    expirationHelper.forget(key);
+
+    expirationHelper.tick(purge);
+    expirationHelper.tick(purge);
+    ASSERT_FALSE(purgeCalled);
+
+    expirationHelper.markInteresting(key, cache);
+    ASSERT_TRUE(cacheCalled);
+}
+
+TEST_F(CacheExpirationHelperTest, shouldEvictLeastRecentlyUsedEntries)
+{
+    one::client::CacheExpirationHelper<int, 3> expirationHelper;
+
+    expirationHelper.markInteresting(key, [] {});
+    expirationHelper.tick(purge);
+    expirationHelper.markInteresting(key1, [] {});
+    expirationHelper.markInteresting(key2, [] {});
+
+    int entries = 3;
+    expirationHelper.evict(
+        [&](int k) {
+            purge(k);
+            --entries;
+        },
+        [&] { return entries > 2; });
+
+    ASSERT_TRUE(purgeCalled);
+    ASSERT_FALSE(purgeCalledK1);
+    ASSERT_FALSE(purgeCalledK2);
+}
+
+TEST_F(CacheExpirationHelperTest, shouldNotEvictPinnedEntries)
+{
+    one::client::CacheExpirationHelper<int, 3> expirationHelper;
+
+    expirationHelper.pin(key, [] {});
+    expirationHelper.markInteresting(key1, [] {});
+
+    expirationHelper.evict(purge, [] { return true; });
+
+    ASSERT_FALSE(purgeCalled);
+    ASSERT_TRUE(purgeCalledK1);
+}
+
+TEST_F(CacheExpirationHelperTest, shouldEvictRecentlyTouchedEntriesLast)
+{
+    one::client::CacheExpirationHelper<int, 3> expirationHelper;
+
+    expirationHelper.markInteresting(key, [] {});
+    expirationHelper.markInteresting(key1, [] {});
+    expirationHelper.tick(purge);
+    expirationHelper.markInteresting(key, [] {});
+
+    int entries = 2;
+    expirationHelper.evict(
+        [&](int k) {
+            purge(k);
+            --entries;
+        },
+        [&] { return entries > 1; });
+
+    ASSERT_FALSE(purgeCalled);
+    ASSERT_TRUE(purgeCalledK1);
+}
+
+TEST_F(CacheExpirationHelperTest, shouldNotShortenTtlOnEvict)
+{
+    one::client::CacheExpirationHelper<int, 3> expirationHelper;
+
+    expirationHelper.pin(key, [] {});
+    expirationHelper.markInteresting(key1, [] {});
+
+    expirationHelper.evict(purge, [] { return true; });
+    ASSERT_TRUE(purgeCalledK1);
+
+    expirationHelper.markInteresting(key2, [] {});
+    expirationHelper.tick(purge);
+    expirationHelper.tick(purge);
+    ASSERT_FALSE(purgeCalledK2);
+
+    expirationHelper.tick(purge);
+    ASSERT_TRUE(purgeCalledK2);
+    ASSERT_FALSE(purgeCalled);
+    ASSERT_TRUE(expirationHelper.tracked(key));
+}
+
+TEST_F(CacheExpirationHelperTest, shouldExpireAnEntryAfterItsOwnTtl)
+{
+    one::client::CacheExpirationHelper<int, 5> expirationHelper;
+
+    expirationHelper.markInteresting(key, [] {});
+    expirationHelper.markInteresting(key1, [] {}, 2);
+    expirationHelper.pin(key2, [] {});
+    expirationHelper.markInteresting(key2, [] {}, 3);
+    expirationHelper.unpin(key2);
+
+    expirationHelper.tick(purge);
+    ASSERT_FALSE(purgeCalledK1);
+
+    expirationHelper.tick(purge);
+    ASSERT_TRUE(purgeCalledK1);
+    ASSERT_FALSE(purgeCalledK2);
+
+    expirationHelper.tick(purge);
+    ASSERT_TRUE(purgeCalledK2);
+
+    expirationHelper.tick(purge);
+    ASSERT_FALSE(purgeCalled);
+
+    expirationHelper.tick(purge);
+    ASSERT_TRUE(purgeCalled);
+}
+
+TEST_F(CacheExpirationHelperTest, shouldExpireAnEntryWithTtlBeyondFirstLevel)
+{
+    one::client::CacheExpirationHelper<int, 2> expirationHelper;
+
+    const int ttl = 10000;
+    expirationHelper.markInteresting(key, [] {}, ttl);
+
+    // Touching the entry halfway keeps its deadline, but shortens its ttl
+    for (int i = 1; i < ttl; ++i) {
+        expirationHelper.tick(purge);
+        ASSERT_FALSE(purgeCalled);
+
+        if (i == ttl / 2)
+            expirationHelper.markInteresting(key, [] {}, ttl / 2);
+    }
+
+    expirationHelper.tick(purge);
+    ASSERT_TRUE(purgeCalled);
+}
@@ -0,0 +1,265 @@
+/**
+ * @file directory_cache_test.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "cache/directoryCache.h"
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace ::testing;
+using namespace one::client;
+
+namespace {
+DirectoryCache::Children children(std::size_t count, std::size_t first = 0)
+{
+    DirectoryCache::Children result;
+    for (auto i = first; i < first + count; ++i)
+        result.emplace_back("uuid" + std::to_string(i),
+            "name" + std::to_string(i));
+
+    return result;
+}
+
+bool contains(const DirectoryCache::Children &listing,
+    const std::string &uuid, const std::string &name)
+{
+    return std::find(listing.begin(), listing.end(),
+               std::make_tuple(uuid, name)) != listing.end();
+}
+}
+
+struct DirectoryCacheTest : public ::testing::Test {
+    DirectoryCache directoryCache{10};
+};
+
+TEST_F(DirectoryCacheTest, getShouldReturnPutListing)
+{
+    EXPECT_FALSE(directoryCache.get("dir"));
+
+    directoryCache.put("dir", children(3));
+
+    auto listing = directoryCache.get("dir");
+    ASSERT_TRUE(listing);
+    EXPECT_EQ(children(3), listing.get());
+    EXPECT_EQ(3u, directoryCache.size());
+}
+
+TEST_F(DirectoryCacheTest, addChildShouldPatchCachedListing)
+{
+    directoryCache.put("dir", children(2));
+
+    directoryCache.addChild("dir", "newUuid", "newName");
+    directoryCache.addChild("dir", "replacedUuid", "name0");
+    directoryCache.addChild("otherDir", "uuid", "name");
+
+    auto listing = directoryCache.get("dir");
+    ASSERT_TRUE(listing);
+    EXPECT_EQ(3u, listing->size());
+    EXPECT_TRUE(contains(*listing, "newUuid", "newName"));
+    EXPECT_TRUE(contains(*listing, "replacedUuid", "name0"));
+    EXPECT_TRUE(contains(*listing, "uuid1", "name1"));
+    EXPECT_FALSE(directoryCache.get("otherDir"));
+}
+
+TEST_F(DirectoryCacheTest, removeChildShouldPatchCachedListing)
+{
+    directoryCache.put("dir", children(3));
+
+    directoryCache.removeChild("dir", "name0");
+    directoryCache.removeChild("dir", "unknownName");
+
+    auto listing = directoryCache.get("dir");
+    ASSERT_TRUE(listing);
+    EXPECT_EQ(2u, listing->size());
+    EXPECT_FALSE(contains(*listing, "uuid0", "name0"));
+    EXPECT_TRUE(contains(*listing, "uuid1", "name1"));
+    EXPECT_TRUE(contains(*listing, "uuid2", "name2"));
+
+    directoryCache.removeChild("dir", "name2");
+    directoryCache.addChild("dir", "uuid3", "name3");
+
+    listing = directoryCache.get("dir");
+    ASSERT_TRUE(listing);
+    EXPECT_EQ(2u, listing->size());
+    EXPECT_TRUE(contains(*listing, "uuid1", "name1"));
+    EXPECT_TRUE(contains(*listing, "uuid3", "name3"));
+}
+
+TEST_F(DirectoryCacheTest, invalidateShouldDropListing)
+{
+    directoryCache.put("dir", children(3));
+
+    directoryCache.invalidate("dir");
+
+    EXPECT_FALSE(directoryCache.get("dir"));
+    EXPECT_EQ(0u, directoryCache.size());
+}
+
+TEST_F(DirectoryCacheTest, putShouldEvictLeastRecentlyUsedListings)
+{
+    directoryCache.put("dir1", children(4));
+    directoryCache.put("dir2", children(4));
+    directoryCache.get("dir1");
+
+    directoryCache.put("dir3", children(4));
+
+    EXPECT_TRUE(directoryCache.get("dir1"));
+    EXPECT_FALSE(directoryCache.get("dir2"));
+    EXPECT_TRUE(directoryCache.get("dir3"));
+    EXPECT_EQ(8u, directoryCache.size());
+}
+
+TEST_F(DirectoryCacheTest, putShouldNotCacheListingsExceedingCapacity)
+{
+    directoryCache.put("dir1", children(4));
+    directoryCache.put("dir2", children(11));
+
+    EXPECT_TRUE(directoryCache.get("dir1"));
+    EXPECT_FALSE(directoryCache.get("dir2"));
+}
+
+TEST_F(DirectoryCacheTest, addChildShouldDropListingGrowingBeyondCapacity)
+{
+    directoryCache.put("dir1", children(4));
+    directoryCache.put("dir2", children(6));
+
+    directoryCache.addChild("dir2", "uuid", "name");
+    EXPECT_FALSE(directoryCache.get("dir1"));
+    EXPECT_TRUE(directoryCache.get("dir2"));
+
+    for (int i = 0; i < 3; ++i)
+        directoryCache.addChild("dir2", "uuid", "name" + std::to_string(i + 6));
+
+    auto listing = directoryCache.get("dir2");
+    ASSERT_TRUE(listing);
+    EXPECT_EQ(10u, listing->size());
+
+    directoryCache.addChild("dir2", "uuid", "anotherName");
+    EXPECT_FALSE(directoryCache.get("dir2"));
+    EXPECT_EQ(0u, directoryCache.size());
+}
+
+TEST_F(DirectoryCacheTest, revalidateShouldRestoreRetiredListingOfUnmodifiedDir)
+{
+    const auto mtime = DirectoryCache::Clock::now() - std::chrono::hours{1};
+    directoryCache.put("dir1", children(3), mtime);
+    directoryCache.put("dir2", children(3), mtime);
+    directoryCache.put("dir3", children(3));
+
+    directoryCache.retire("dir1");
+    directoryCache.retire("dir2");
+    directoryCache.retire("dir3");
+    EXPECT_FALSE(directoryCache.get("dir1"));
+    EXPECT_EQ(0u, directoryCache.size());
+    EXPECT_EQ(6u, directoryCache.unverifiedSize());
+
+    EXPECT_TRUE(directoryCache.revalidate("dir1", mtime));
+    EXPECT_FALSE(
+        directoryCache.revalidate("dir2", mtime + std::chrono::seconds{1}));
+    EXPECT_FALSE(directoryCache.revalidate("dir3", mtime));
+
+    auto listing = directoryCache.get("dir1");
+    ASSERT_TRUE(listing);
+    EXPECT_EQ(children(3), listing.get());
+    EXPECT_FALSE(directoryCache.get("dir2"));
+    EXPECT_EQ(0u, directoryCache.unverifiedSize());
+}
+
+TEST_F(DirectoryCacheTest, retireShouldNotKeepListingsOfRecentlyModifiedDirs)
+{
+    const auto mtime = DirectoryCache::Clock::now();
+    directoryCache.put("dir", children(3), mtime);
+
+    directoryCache.retire("dir");
+
+    EXPECT_EQ(0u, directoryCache.unverifiedSize());
+    EXPECT_FALSE(directoryCache.revalidate("dir", mtime));
+}
+
+TEST_F(DirectoryCacheTest, invalidateShouldDropUnverifiedListing)
+{
+    const auto mtime = DirectoryCache::Clock::now() - std::chrono::hours{1};
+    directoryCache.put("dir", children(3), mtime);
+    directoryCache.retire("dir");
+
+    directoryCache.invalidate("dir");
+
+    EXPECT_FALSE(directoryCache.revalidate("dir", mtime));
+}
+
+TEST_F(DirectoryCacheTest, loadShouldReturnListingsSavedByPreviousCache)
+{
+    const auto file = boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path();
+    const auto mtime = DirectoryCache::Clock::from_time_t(
+        DirectoryCache::Clock::to_time_t(DirectoryCache::Clock::now()) - 3600);
+
+    directoryCache.put("dir1", children(3), mtime);
+    directoryCache.put("dir2", children(2), mtime);
+    directoryCache.retire("dir2");
+    directoryCache.put("dir3", children(3));
+
+    EXPECT_TRUE(directoryCache.save(file));
+    EXPECT_FALSE(directoryCache.save(file));
+
+    DirectoryCache loadedCache{10};
+    EXPECT_EQ(2u, loadedCache.load(file));
+    EXPECT_EQ(0u, loadedCache.size());
+    EXPECT_EQ(5u, loadedCache.unverifiedSize());
+
+    EXPECT_TRUE(loadedCache.revalidate("dir1", mtime));
+    EXPECT_TRUE(loadedCache.revalidate("dir2", mtime));
+    EXPECT_FALSE(loadedCache.revalidate("dir3", mtime));
+
+    auto listing = loadedCache.get("dir1");
+    ASSERT_TRUE(listing);
+    EXPECT_EQ(children(3), listing.get());
+
+    boost::filesystem::remove(file);
+}
+
+TEST_F(DirectoryCacheTest, loadShouldIgnoreMissingAndCorruptedFiles)
+{
+    const auto file = boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path();
+
+    EXPECT_EQ(0u, directoryCache.load(file));
+
+    directoryCache.put("dir", children(3),
+        DirectoryCache::Clock::now() - std::chrono::hours{1});
+    ASSERT_TRUE(directoryCache.save(file));
+
+    auto size = boost::filesystem::file_size(file);
+    boost::filesystem::resize_file(file, size - 1);
+
+    DirectoryCache loadedCache{10};
+    EXPECT_EQ(0u, loadedCache.load(file));
+    EXPECT_EQ(0u, loadedCache.unverifiedSize());
+
+    boost::filesystem::remove(file);
+}
+
+TEST_F(DirectoryCacheTest, saveShouldBeRetriedAfterFailure)
+{
+    const auto dir = boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path();
+    const auto file = dir / "cache";
+
+    directoryCache.put("dir", children(3),
+        DirectoryCache::Clock::now() - std::chrono::hours{1});
+    EXPECT_THROW(directoryCache.save(file), std::system_error);
+
+    boost::filesystem::create_directory(dir);
+    EXPECT_TRUE(directoryCache.save(file));
+    EXPECT_FALSE(directoryCache.save(file));
+
+    boost::filesystem::remove_all(dir);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file inode_cache_test.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "cache/inodeCache.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace ::testing;
+using namespace one::client;
+
+struct InodeCacheTest : public ::testing::Test {
+    InodeCache inodeCache;
+};
+
+TEST_F(InodeCacheTest, setRootShouldMapRootInode)
+{
+    EXPECT_FALSE(inodeCache.hasRoot());
+
+    inodeCache.setRoot("rootUuid");
+
+    EXPECT_TRUE(inodeCache.hasRoot());
+    EXPECT_EQ("rootUuid", inodeCache.uuid(FUSE_ROOT_ID));
+    EXPECT_EQ(FUSE_ROOT_ID, inodeCache.inode("rootUuid").get());
+}
+
+TEST_F(InodeCacheTest, lookupShouldAssignStableInodes)
+{
+    auto first = inodeCache.lookup("uuid1");
+    auto second = inodeCache.lookup("uuid2");
+    auto again = inodeCache.lookup("uuid1");
+
+    EXPECT_TRUE(first.second);
+    EXPECT_TRUE(second.second);
+    EXPECT_FALSE(again.second);
+    EXPECT_NE(FUSE_ROOT_ID, first.first);
+    EXPECT_NE(first.first, second.first);
+    EXPECT_EQ(first.first, again.first);
+    EXPECT_EQ("uuid1", inodeCache.uuid(first.first));
+}
+
+TEST_F(InodeCacheTest, uuidShouldThrowForUnknownInode)
+{
+    EXPECT_THROW(inodeCache.uuid(1234), std::errc);
+    EXPECT_FALSE(inodeCache.inode("uuid"));
+}
+
+TEST_F(InodeCacheTest, forgetShouldReleaseInodeWhenLookupCountDropsToZero)
+{
+    auto inode = inodeCache.lookup("uuid").first;
+    inodeCache.lookup("uuid");
+
+    EXPECT_FALSE(inodeCache.forget(inode, 1));
+    EXPECT_EQ("uuid", inodeCache.uuid(inode));
+
+    auto released = inodeCache.forget(inode, 1);
+    ASSERT_TRUE(released);
+    EXPECT_EQ("uuid", released.get());
+    EXPECT_THROW(inodeCache.uuid(inode), std::errc);
+    EXPECT_FALSE(inodeCache.inode("uuid"));
+}
+
+TEST_F(InodeCacheTest, forgetShouldNeverReleaseRootInode)
+{
+    inodeCache.setRoot("rootUuid");
+
+    EXPECT_FALSE(inodeCache.forget(FUSE_ROOT_ID, 100));
+    EXPECT_EQ("rootUuid", inodeCache.uuid(FUSE_ROOT_ID));
+}
+
+TEST_F(InodeCacheTest, renameShouldKeepInodeOfRenamedFile)
+{
+    auto inode = inodeCache.lookup("oldUuid").first;
+
+    inodeCache.rename("oldUuid", "newUuid");
+
+    EXPECT_EQ("newUuid", inodeCache.uuid(inode));
+    EXPECT_EQ(inode, inodeCache.inode("newUuid").get());
+    EXPECT_FALSE(inodeCache.inode("oldUuid"));
+    EXPECT_EQ(inode, inodeCache.lookup("newUuid").first);
+}
+
+TEST_F(InodeCacheTest, renameShouldKeepInodesOfBothUuids)
+{
+    auto renamed = inodeCache.lookup("oldUuid").first;
+    auto existing = inodeCache.lookup("newUuid").first;
+
+    inodeCache.rename("oldUuid", "newUuid");
+
+    EXPECT_EQ("newUuid", inodeCache.uuid(renamed));
+    EXPECT_EQ(existing, inodeCache.inode("newUuid").get());
+    EXPECT_EQ(std::vector<InodeCache::Inode>({existing, renamed}),
+        inodeCache.inodes("newUuid"));
+
+    ASSERT_TRUE(inodeCache.forget(renamed, 1));
+    EXPECT_EQ(std::vector<InodeCache::Inode>({existing}),
+        inodeCache.inodes("newUuid"));
+}
+
+TEST_F(InodeCacheTest, lookupShouldNotRaceWithForget)
+{
+    std::atomic<bool> lost{false};
+    auto lookupAndForget = [&] {
+        for (int i = 0; i < 10000; ++i) {
+            auto inode = inodeCache.lookup("uuid").first;
+            std::this_thread::yield();
+            auto inodes = inodeCache.inodes("uuid");
+            if (std::find(inodes.begin(), inodes.end(), inode) == inodes.end())
+                lost = true;
+
+            inodeCache.forget(inode, 1);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+        threads.emplace_back(lookupAndForget);
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_FALSE(lost);
+    EXPECT_FALSE(inodeCache.inode("uuid"));
+}
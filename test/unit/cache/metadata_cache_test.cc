@@ -0,0 +1,122 @@
+/**
+ * @file metadata_cache_test.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "cache/metadataCache.h"
+#include "communication/communicator.h"
+#include "messages.pb.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <string>
+
+using namespace ::testing;
+using namespace one;
+using namespace one::client;
+using namespace one::communication;
+using namespace std::literals;
+
+class MetadataCacheTest : public ::testing::Test {
+public:
+    MetadataCacheTest()
+        : communicator{1, "localhost", 80, false, createConnection}
+        , metadataCache{communicator}
+    {
+        metadataCache.putAttr(fileAttr(0));
+    }
+
+protected:
+    MetadataCache::FileAttr fileAttr(const off_t size)
+    {
+        clproto::FileAttr msg;
+        msg.set_uuid(uuid);
+        msg.set_name("file");
+        msg.set_type(clproto::FileType::REG);
+        msg.set_size(size);
+        return MetadataCache::FileAttr{msg};
+    }
+
+    std::string uuid = "uuid";
+    Communicator communicator;
+    MetadataCache metadataCache;
+};
+
+TEST_F(MetadataCacheTest, getAttrShouldNotWaitForHeldAccessor)
+{
+    MetadataCache::MetaAccessor acc;
+    ASSERT_TRUE(metadataCache.get(acc, uuid));
+
+    auto size = std::async(std::launch::async,
+        [&] { return metadataCache.getAttr(uuid).size().get(); });
+
+    EXPECT_EQ(std::future_status::ready, size.wait_for(5s));
+
+    acc.release();
+    EXPECT_EQ(0, size.get());
+}
+
+TEST_F(MetadataCacheTest, getAttrShouldReturnLastPublishedAttributes)
+{
+    MetadataCache::MetaAccessor acc;
+    ASSERT_TRUE(metadataCache.get(acc, uuid));
+    acc.attr().size(10);
+
+    EXPECT_EQ(0, metadataCache.getAttrSnapshot(uuid)->size().get());
+
+    acc.release();
+    EXPECT_EQ(10, metadataCache.getAttrSnapshot(uuid)->size().get());
+    EXPECT_EQ(10, metadataCache.getAttr(uuid).size().get());
+
+    {
+        MetadataCache::MetaAccessor otherAcc;
+        ASSERT_TRUE(metadataCache.get(otherAcc, uuid));
+        otherAcc.attr(fileAttr(20));
+    }
+
+    EXPECT_EQ(20, metadataCache.getAttr(uuid).size().get());
+}
+
+TEST_F(MetadataCacheTest, releaseShouldNotPublishUnchangedAttributes)
+{
+    auto snapshot = metadataCache.getAttrSnapshot(uuid);
+
+    MetadataCache::MetaAccessor acc;
+    ASSERT_TRUE(metadataCache.get(acc, uuid));
+    acc->second.locations.clear();
+    acc.release();
+
+    EXPECT_EQ(snapshot, metadataCache.getAttrSnapshot(uuid));
+}
+
+TEST_F(MetadataCacheTest, removeShouldDropPublishedAttributes)
+{
+    ASSERT_TRUE(metadataCache.hasAttr(uuid));
+
+    metadataCache.remove(uuid);
+
+    EXPECT_FALSE(metadataCache.hasAttr(uuid));
+    EXPECT_EQ(nullptr, metadataCache.getAttrSnapshot(uuid));
+    EXPECT_EQ(0u, metadataCache.size());
+}
+
+TEST_F(MetadataCacheTest, getShouldWaitForHeldAccessor)
+{
+    MetadataCache::MetaAccessor acc;
+    ASSERT_TRUE(metadataCache.get(acc, uuid));
+
+    auto found = std::async(std::launch::async, [&] {
+        MetadataCache::MetaAccessor otherAcc;
+        return metadataCache.get(otherAcc, uuid);
+    });
+
+    EXPECT_EQ(std::future_status::timeout, found.wait_for(100ms));
+
+    acc.release();
+    EXPECT_TRUE(found.get());
+}
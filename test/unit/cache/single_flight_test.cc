@@ -0,0 +1,135 @@
+/**
+ * @file single_flight_test.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "cache/singleFlight.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace ::testing;
+using namespace one::client;
+
+namespace {
+
+constexpr std::size_t FLIGHT_THREADS = 10;
+
+std::mutex latchMutex;
+std::condition_variable latchCondition;
+std::unordered_map<std::thread::id, int> hashCalls;
+std::size_t landedThreads = 0;
+
+/**
+ * Hashes all keys to one bucket, so that no bucket is ever rehashed, and
+ * holds the threads calling it. A thread hashes the key first when it
+ * enters @c SingleFlight::get and again when it lands the flight; landing
+ * waits until all threads have landed, so that no flight lands before
+ * every thread has joined it.
+ */
+struct LatchedHashCompare {
+    std::size_t hash(const std::string &) const
+    {
+        std::unique_lock<std::mutex> lock{latchMutex};
+        if (++hashCalls[std::this_thread::get_id()] == 2) {
+            ++landedThreads;
+            latchCondition.notify_all();
+            latchCondition.wait(
+                lock, [] { return landedThreads == FLIGHT_THREADS; });
+        }
+        else {
+            latchCondition.notify_all();
+        }
+
+        return 0;
+    }
+
+    bool equal(const std::string &a, const std::string &b) const
+    {
+        return a == b;
+    }
+};
+
+} // namespace
+
+struct SingleFlightTest : public ::testing::Test {
+    SingleFlight<std::string, int> singleFlight;
+};
+
+TEST_F(SingleFlightTest, getShouldShareFetchInFlight)
+{
+    hashCalls.clear();
+    landedThreads = 0;
+
+    SingleFlight<std::string, int, LatchedHashCompare> latchedSingleFlight;
+    std::atomic<int> fetches{0};
+
+    auto fetch = [&] {
+        ++fetches;
+        std::unique_lock<std::mutex> lock{latchMutex};
+        latchCondition.wait(
+            lock, [] { return hashCalls.size() == FLIGHT_THREADS; });
+
+        std::promise<int> promise;
+        promise.set_value(42);
+        return promise.get_future();
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<int> values(FLIGHT_THREADS, 0);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        threads.emplace_back(
+            [&, i] { values[i] = latchedSingleFlight.get("key", fetch); });
+
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(1, fetches);
+    EXPECT_EQ(std::vector<int>(FLIGHT_THREADS, 42), values);
+    EXPECT_EQ(0u, latchedSingleFlight.size());
+}
+
+TEST_F(SingleFlightTest, getShouldFetchAgainAfterFlightHasLanded)
+{
+    int fetches = 0;
+    auto fetch = [&] {
+        std::promise<int> promise;
+        promise.set_value(++fetches);
+        return promise.get_future();
+    };
+
+    EXPECT_EQ(1, singleFlight.get("key", fetch));
+    EXPECT_EQ(2, singleFlight.get("key", fetch));
+    EXPECT_EQ(3, singleFlight.get("otherKey", fetch));
+}
+
+TEST_F(SingleFlightTest, getShouldPassFetchErrorsToAllWaiters)
+{
+    auto fetch = [] {
+        std::promise<int> promise;
+        promise.set_exception(std::make_exception_ptr(std::system_error{
+            std::make_error_code(std::errc::no_such_file_or_directory)}));
+        return promise.get_future();
+    };
+
+    EXPECT_THROW(singleFlight.get("key", fetch), std::system_error);
+    EXPECT_EQ(0u, singleFlight.size());
+
+    auto failingFetch = []() -> std::future<int> {
+        throw std::runtime_error{"fetch not launched"};
+    };
+
+    EXPECT_THROW(singleFlight.get("key", failingFetch), std::runtime_error);
+    EXPECT_EQ(0u, singleFlight.size());
+}
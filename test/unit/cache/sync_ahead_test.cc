@@ -0,0 +1,105 @@
+/**
+ * @file sync_ahead_test.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "cache/syncAhead.h"
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using namespace one::client;
+using namespace std::literals;
+
+namespace {
+auto range(off_t start, off_t end)
+{
+    return boost::icl::discrete_interval<off_t>::right_open(start, end);
+}
+}
+
+struct SyncAheadTest : public ::testing::Test {
+    SyncAhead syncAhead{100, 1000};
+};
+
+TEST_F(SyncAheadTest, onReadShouldNotSyncAheadOfSingleRead)
+{
+    EXPECT_FALSE(syncAhead.onRead(0, 10, 10000));
+}
+
+TEST_F(SyncAheadTest, onReadShouldSyncWindowAheadOfSequentialReader)
+{
+    syncAhead.onRead(0, 10, 10000);
+
+    auto toSync = syncAhead.onRead(10, 10, 10000);
+    ASSERT_TRUE(toSync);
+    EXPECT_EQ(range(20, 120), toSync.get());
+}
+
+TEST_F(SyncAheadTest, onReadShouldRefillWindowOnceHalfOfItIsConsumed)
+{
+    syncAhead.onRead(0, 10, 10000);
+    syncAhead.onRead(10, 10, 10000);
+
+    EXPECT_FALSE(syncAhead.onRead(20, 40, 10000));
+
+    auto toSync = syncAhead.onRead(60, 10, 10000);
+    ASSERT_TRUE(toSync);
+    EXPECT_EQ(range(120, 170), toSync.get());
+}
+
+TEST_F(SyncAheadTest, onReadShouldNotSyncBeyondFileSize)
+{
+    syncAhead.onRead(0, 10, 50);
+
+    auto toSync = syncAhead.onRead(10, 10, 50);
+    ASSERT_TRUE(toSync);
+    EXPECT_EQ(range(20, 50), toSync.get());
+
+    EXPECT_FALSE(syncAhead.onRead(20, 10, 50));
+}
+
+TEST_F(SyncAheadTest, onReadShouldResetOnRandomAccess)
+{
+    syncAhead.onRead(0, 10, 10000);
+    syncAhead.onRead(10, 10, 10000);
+    syncAhead.onStall(0ms);
+    EXPECT_EQ(200, syncAhead.window());
+
+    EXPECT_FALSE(syncAhead.onRead(5000, 10, 10000));
+    EXPECT_EQ(100, syncAhead.window());
+
+    auto toSync = syncAhead.onRead(5010, 10, 10000);
+    ASSERT_TRUE(toSync);
+    EXPECT_EQ(range(5020, 5120), toSync.get());
+}
+
+TEST_F(SyncAheadTest, onStallShouldDoubleWindowUpToMaximum)
+{
+    syncAhead.onStall(0ms);
+    EXPECT_EQ(100, syncAhead.window());
+
+    syncAhead.onRead(0, 10, 10000);
+    syncAhead.onRead(10, 10, 10000);
+
+    syncAhead.onStall(0ms);
+    EXPECT_EQ(200, syncAhead.window());
+
+    for (int i = 0; i < 10; ++i)
+        syncAhead.onStall(0ms);
+
+    EXPECT_EQ(1000, syncAhead.window());
+}
+
+TEST_F(SyncAheadTest, onStallShouldGrowWindowWithTransferRate)
+{
+    syncAhead.onRead(0, 10, 10000);
+    syncAhead.onRead(10, 10, 10000);
+
+    // The reader consumes far more than the window during a long stall
+    syncAhead.onStall(1h);
+    EXPECT_EQ(1000, syncAhead.window());
+}
@@ -0,0 +1,104 @@
+/**
+ * @file write_accumulator_test.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "cache/writeAccumulator.h"
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using namespace one::client;
+
+namespace {
+WriteAccumulator::FileBlocksMap blocks(
+    off_t lower, off_t upper, std::string fileId = "fileId")
+{
+    WriteAccumulator::FileBlocksMap result;
+    result += std::make_pair(
+        boost::icl::discrete_interval<off_t>::right_open(lower, upper),
+        one::messages::fuse::FileBlock{"storageId", std::move(fileId)});
+    return result;
+}
+}
+
+struct WriteAccumulatorTest : public ::testing::Test {
+    WriteAccumulator accumulator{{one::helpers::Flag::RDWR}, 3};
+};
+
+TEST_F(WriteAccumulatorTest, flushShouldPublishMergedSequentialWrites)
+{
+    EXPECT_TRUE(accumulator.empty());
+
+    for (off_t offset = 0; offset < 40960; offset += 4096)
+        EXPECT_FALSE(accumulator.add(blocks(offset, offset + 4096)));
+
+    EXPECT_FALSE(accumulator.empty());
+
+    int published = 0;
+    accumulator.flush(
+        [&](const WriteAccumulator::FileBlocksMap &pending, const off_t end) {
+            ++published;
+            EXPECT_EQ(blocks(0, 40960), pending);
+            EXPECT_EQ(40960, end);
+        });
+
+    accumulator.flush([&](const WriteAccumulator::FileBlocksMap &,
+        const off_t) { ++published; });
+
+    EXPECT_EQ(1, published);
+    EXPECT_TRUE(accumulator.empty());
+}
+
+TEST_F(WriteAccumulatorTest, addShouldRequestPublishingOfFragmentedWrites)
+{
+    EXPECT_FALSE(accumulator.add(blocks(0, 10)));
+    EXPECT_FALSE(accumulator.add(blocks(20, 30)));
+    EXPECT_FALSE(accumulator.add(blocks(10, 20)));
+    EXPECT_FALSE(accumulator.add(blocks(40, 50)));
+    EXPECT_FALSE(accumulator.add(blocks(40, 50, "otherFileId")));
+    EXPECT_TRUE(accumulator.add(blocks(50, 60, "otherFileId")));
+}
+
+TEST_F(WriteAccumulatorTest, flushShouldKeepBlocksPendingIfPublishingFails)
+{
+    accumulator.add(blocks(100, 200));
+    accumulator.add(blocks(0, 10));
+
+    EXPECT_THROW(
+        accumulator.flush([](const WriteAccumulator::FileBlocksMap &,
+            const off_t) { throw std::errc::no_such_file_or_directory; }),
+        std::errc);
+
+    EXPECT_FALSE(accumulator.empty());
+    accumulator.flush(
+        [&](const WriteAccumulator::FileBlocksMap &pending, const off_t end) {
+            EXPECT_EQ(2u, pending.iterative_size());
+            EXPECT_EQ(200, end);
+        });
+}
+
+TEST(WriteAccumulatorCounterTest, shouldCountAccumulatorsWithPendingBlocks)
+{
+    auto pending = std::make_shared<std::atomic<std::size_t>>(0);
+    WriteAccumulator first{{one::helpers::Flag::RDWR}, 3, pending};
+    WriteAccumulator second{{one::helpers::Flag::WRONLY}, 3, pending};
+    auto publish = [](const WriteAccumulator::FileBlocksMap &, const off_t) {};
+
+    first.add(blocks(0, 10));
+    first.add(blocks(10, 20));
+    EXPECT_EQ(1u, *pending);
+
+    second.add(blocks(20, 30));
+    EXPECT_EQ(2u, *pending);
+
+    first.flush(publish);
+    first.flush(publish);
+    EXPECT_EQ(1u, *pending);
+
+    second.flush(publish);
+    EXPECT_EQ(0u, *pending);
+}
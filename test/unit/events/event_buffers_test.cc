@@ -8,10 +8,12 @@
 
 #include "eventTestUtils.h"
 #include "events/buffers/eventBufferMap.h"
+#include "events/buffers/threadLocalEventBuffer.h"
 #include "events/buffers/voidEventBuffer.h"
 
 #include <algorithm>
 #include <functional>
+#include <thread>
 #include <vector>
 
 using namespace one::client::events;
@@ -122,3 +124,94 @@ TYPED_TEST(EventBufferMapTest, EventBufferMapShouldClearOnDestruction)
 
     EXPECT_EQ(5, this->events.size());
 }
+
+template <class EventT>
+class ThreadLocalEventBufferTest : public ::testing::Test {
+public:
+    using EventPtr = typename EventT::EventPtr;
+
+    ThreadLocalEventBufferTest()
+        : buffer{std::make_unique<ThreadLocalEventBuffer<EventT>>(
+              3, [this](EventPtr evt) { events.emplace_back(*evt); })}
+    {
+    }
+
+protected:
+    std::vector<EventT> events;
+    std::unique_ptr<ThreadLocalEventBuffer<EventT>> buffer;
+};
+
+TYPED_TEST_CASE(ThreadLocalEventBufferTest, TestEventTypes);
+
+TYPED_TEST(ThreadLocalEventBufferTest, pushShouldPassEventsOnCounterThreshold)
+{
+    for (int i = 0; i < 5; ++i)
+        this->buffer->push(std::make_unique<TypeParam>("1"));
+
+    ASSERT_EQ(1u, this->events.size());
+    EXPECT_EQ("1", this->events[0].fileUuid());
+    EXPECT_EQ(3u, this->events[0].counter());
+
+    this->buffer->flush();
+
+    ASSERT_EQ(2u, this->events.size());
+    EXPECT_EQ(2u, this->events[1].counter());
+}
+
+TYPED_TEST(ThreadLocalEventBufferTest, emplaceShouldCreateEventsOnlyForNewKeys)
+{
+    int created = 0;
+    for (int i = 0; i < 5; ++i)
+        this->buffer->emplace("1",
+            [&] {
+                ++created;
+                return std::make_unique<TypeParam>("1");
+            },
+            [](TypeParam &event) {
+                event.aggregate(std::make_unique<TypeParam>("1"));
+            });
+
+    EXPECT_EQ(2, created);
+    ASSERT_EQ(1u, this->events.size());
+    EXPECT_EQ(3u, this->events[0].counter());
+
+    this->buffer->flush();
+
+    ASSERT_EQ(2u, this->events.size());
+    EXPECT_EQ(2u, this->events[1].counter());
+}
+
+TYPED_TEST(ThreadLocalEventBufferTest, flushShouldCollectEventsOfAllThreads)
+{
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+        threads.emplace_back([this] {
+            this->buffer->push(std::make_unique<TypeParam>("1"));
+            this->buffer->push(std::make_unique<TypeParam>("2"));
+            this->buffer->push(std::make_unique<TypeParam>("2"));
+        });
+
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_TRUE(this->events.empty());
+
+    this->buffer->flush("1");
+
+    ASSERT_EQ(4u, this->events.size());
+    for (const auto &event : this->events) {
+        EXPECT_EQ("1", event.fileUuid());
+        EXPECT_EQ(1u, event.counter());
+    }
+
+    this->buffer->flush("1");
+    EXPECT_EQ(4u, this->events.size());
+
+    this->buffer.reset();
+
+    ASSERT_EQ(8u, this->events.size());
+    for (auto i = 4u; i < this->events.size(); ++i) {
+        EXPECT_EQ("2", this->events[i].fileUuid());
+        EXPECT_EQ(2u, this->events[i].counter());
+    }
+}
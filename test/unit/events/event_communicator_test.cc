@@ -12,6 +12,7 @@
 #include "events/buffers/eventBufferMap.h"
 #include "typedStream_mock.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -54,3 +55,95 @@ TYPED_TEST(EventCommunicatorTest, processShouldSendEvent)
     events.emplace_back(std::make_unique<TypeParam>("fileUuid"));
     this->communicator.send(std::move(events));
 }
+
+TYPED_TEST(EventCommunicatorTest, sendShouldDeferEventsWhileStreamIsSaturated)
+{
+    std::string sentEvents;
+    EXPECT_CALL(*this->stream, close()).Times(1);
+    EXPECT_CALL(*this->stream, bufferedSize())
+        .WillOnce(Return(1000))
+        .WillOnce(Return(1000))
+        .WillRepeatedly(Return(999));
+    EXPECT_CALL(*this->stream, send(_))
+        .WillOnce(Invoke([&](const one::messages::ClientMessage &msg) {
+            sentEvents = msg.toString();
+        }));
+
+    this->communicator.setMaxBufferedSize(1000);
+
+    std::vector<std::unique_ptr<TypeParam>> events;
+    events.emplace_back(std::make_unique<TypeParam>("fileUuid"));
+    this->communicator.send(std::move(events));
+    EXPECT_TRUE(sentEvents.empty());
+
+    events.clear();
+    events.emplace_back(std::make_unique<TypeParam>("fileUuid"));
+    this->communicator.send(std::move(events));
+    EXPECT_NE(std::string::npos, sentEvents.find("counter: 2"));
+}
+
+TYPED_TEST(EventCommunicatorTest, flushDeferredShouldSendEventsOnceStreamDrains)
+{
+    int flushesScheduled = 0;
+    std::function<void()> flush;
+    EXPECT_CALL(*this->stream, bufferedSize())
+        .WillOnce(Return(1000))
+        .WillOnce(Return(1000))
+        .WillOnce(Return(1000))
+        .WillRepeatedly(Return(0));
+
+    this->communicator.setMaxBufferedSize(1000);
+    this->communicator.setDeferredFlushHandler([&](auto f) {
+        ++flushesScheduled;
+        flush = std::move(f);
+    });
+
+    std::vector<std::unique_ptr<TypeParam>> events;
+    events.emplace_back(std::make_unique<TypeParam>("fileUuid"));
+    this->communicator.send(std::move(events));
+    EXPECT_EQ(1, flushesScheduled);
+
+    EXPECT_CALL(*this->stream, send(_)).Times(0);
+    auto pendingFlush = flush;
+    pendingFlush();
+    EXPECT_EQ(2, flushesScheduled);
+    Mock::VerifyAndClearExpectations(this->stream.get());
+
+    EXPECT_CALL(*this->stream, close()).Times(1);
+    EXPECT_CALL(*this->stream, bufferedSize()).WillRepeatedly(Return(0));
+    EXPECT_CALL(*this->stream, send(_)).Times(1);
+    pendingFlush = flush;
+    pendingFlush();
+    EXPECT_EQ(2, flushesScheduled);
+}
+
+TYPED_TEST(EventCommunicatorTest, sendShouldNotSendWhileStreamIsSaturated)
+{
+    EXPECT_CALL(*this->stream, bufferedSize()).WillRepeatedly(Return(1000));
+    EXPECT_CALL(*this->stream, send(_)).Times(0);
+
+    this->communicator.setMaxBufferedSize(1000);
+
+    for (int i = 0; i < 100; ++i) {
+        std::vector<std::unique_ptr<TypeParam>> events;
+        events.emplace_back(std::make_unique<TypeParam>(std::to_string(i)));
+        events.emplace_back(std::make_unique<TypeParam>("fileUuid"));
+        this->communicator.send(std::move(events));
+    }
+
+    EXPECT_GT(this->communicator.droppedEvents(), 0u);
+    EXPECT_LT(this->communicator.droppedEvents(), 100u);
+    Mock::VerifyAndClearExpectations(this->stream.get());
+
+    std::string sentEvents;
+    EXPECT_CALL(*this->stream, close()).Times(1);
+    EXPECT_CALL(*this->stream, bufferedSize()).WillRepeatedly(Return(0));
+    EXPECT_CALL(*this->stream, send(_))
+        .WillOnce(Invoke([&](const one::messages::ClientMessage &msg) {
+            sentEvents = msg.toString();
+        }));
+
+    this->communicator.send(std::vector<std::unique_ptr<TypeParam>>{});
+    EXPECT_NE(std::string::npos, sentEvents.find("counter: 100"));
+    EXPECT_EQ(0u, this->communicator.droppedEvents());
+}
@@ -16,8 +16,11 @@
 
 #include "messages.pb.h"
 
+#include <asio/post.hpp>
 #include <gmock/gmock.h>
 
+#include <chrono>
+#include <future>
 #include <memory>
 
 using namespace ::testing;
@@ -25,6 +28,7 @@ using namespace one;
 using namespace one::client;
 using namespace one::client::events;
 using namespace one::communication;
+using namespace std::literals;
 
 class ProxyEventManager : public EventManager {
 public:
@@ -50,6 +54,8 @@ public:
     {
         m_registry = std::move(registry);
     }
+
+    asio::io_service &ioService() { return m_ioService; }
 };
 
 class EventManagerTest : public ::testing::Test {
@@ -77,7 +83,7 @@ TEST_F(EventManagerTest, handleShouldForwardReadEventSubscription)
     subscriptionMsg->mutable_read_subscription();
 
     auto readEventStream = std::make_unique<MockEventStream<ReadEventStream>>(
-        streamManager->create());
+        eventManager->ioService(), streamManager->create());
     EXPECT_CALL(*readEventStream, subscribe(_)).Times(1);
     eventManager->setReadEventStream(std::move(readEventStream));
 
@@ -91,7 +97,7 @@ TEST_F(EventManagerTest, handleShouldForwardWriteEventSubscription)
     subscriptionMsg->mutable_write_subscription();
 
     auto writeEventStream = std::make_unique<MockEventStream<WriteEventStream>>(
-        streamManager->create());
+        eventManager->ioService(), streamManager->create());
     EXPECT_CALL(*writeEventStream, subscribe(_)).Times(1);
     eventManager->setWriteEventStream(std::move(writeEventStream));
 
@@ -109,3 +115,18 @@ TEST_F(EventManagerTest, handleShouldForwardSubscriptionCancellation)
 
     eventManager->handle(*subscription);
 }
+
+TEST_F(EventManagerTest, streamShouldNotWaitForStrandOnEventThread)
+{
+    std::promise<void> destroyed;
+    asio::post(eventManager->ioService(), [&] {
+        auto stream = std::make_unique<FileAccessedEventStream>(
+            eventManager->ioService(), streamManager->create());
+        stream->flush();
+        stream.reset();
+        destroyed.set_value();
+    });
+
+    EXPECT_EQ(std::future_status::ready,
+        destroyed.get_future().wait_for(5s));
+}
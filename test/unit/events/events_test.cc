@@ -7,6 +7,7 @@
  */
 
 #include "eventTestUtils.h"
+#include "events/eventContainer.h"
 
 #include "messages.pb.h"
 
@@ -42,6 +43,16 @@ TEST_F(ReadEventTest, aggregateShouldMergeEvents)
     EXPECT_TRUE(blocks({{0, 30}}) == event->blocks());
 }
 
+TEST_F(ReadEventTest, aggregateShouldMergeOperationInPlace)
+{
+    event->aggregate(20, 10);
+    event->aggregate(5, 20);
+    EXPECT_EQ(3, event->counter());
+    EXPECT_EQ("fileUuid1", event->fileUuid());
+    EXPECT_EQ(40, event->size());
+    EXPECT_TRUE(blocks({{0, 30}}) == event->blocks());
+}
+
 TEST_F(ReadEventTest, serializeShouldCreateProtocolMessage)
 {
     one::clproto::Event eventMsg{};
@@ -90,3 +101,142 @@ TEST_F(WriteEventTest, serializeShouldCreateProtocolMessage)
     EXPECT_EQ(eventMsg.SerializeAsString(),
         event->serializeAndDestroy()->SerializeAsString());
 }
+
+TEST(WriteEventBlocksTest, aggregateShouldMergeEventsSpanningManyBlocks)
+{
+    WriteEvent::FileBlocksMap writtenBlocks;
+    writtenBlocks += std::make_pair(
+        boost::icl::discrete_interval<off_t>::right_open(0, 10),
+        WriteEvent::FileBlock{"storageId1", "fileId1"});
+    writtenBlocks += std::make_pair(
+        boost::icl::discrete_interval<off_t>::right_open(10, 20),
+        WriteEvent::FileBlock{"storageId2", "fileId2"});
+
+    auto event = std::make_unique<WriteEvent>(20, "fileUuid1", writtenBlocks);
+    EXPECT_EQ(1, event->counter());
+    EXPECT_EQ(20, event->size());
+    EXPECT_FALSE(event->fileSize());
+    EXPECT_TRUE(writtenBlocks == event->blocks());
+
+    event->aggregate(writeEventPtr(20, 10, "fileUuid1"));
+    EXPECT_EQ(2, event->counter());
+    EXPECT_EQ(30, event->size());
+    EXPECT_EQ(3, event->blocks().iterative_size());
+}
+
+TEST(WriteEventBlocksTest, aggregateShouldMergeBlocksInPlace)
+{
+    WriteEvent::FileBlocksMap writtenBlocks;
+    writtenBlocks += std::make_pair(
+        boost::icl::discrete_interval<off_t>::right_open(10, 20),
+        WriteEvent::FileBlock{"storageId1", "fileId1"});
+
+    auto event = std::make_unique<WriteEvent>(0, 10, 15, "fileUuid1",
+        "storageId1", "fileId1");
+    event->aggregate(10, writtenBlocks);
+
+    EXPECT_EQ(2, event->counter());
+    EXPECT_EQ(20, event->size());
+    EXPECT_EQ(20, event->fileSize().get());
+    EXPECT_EQ(1, event->blocks().iterative_size());
+}
+
+TEST_F(WriteEventTest, serializeShouldCutBlocksAtFileSize)
+{
+    event->aggregate(writeEventPtr(20, 10, "fileUuid1"));
+    event->aggregate(std::make_unique<WriteEvent>(0, 0, 25, "fileUuid1"));
+
+    one::clproto::Event eventMsg{};
+    eventMsg.set_counter(3);
+    auto writeEventMsg = eventMsg.mutable_write_event();
+    writeEventMsg->set_file_uuid("fileUuid1");
+    writeEventMsg->set_size(20);
+    writeEventMsg->set_file_size(25);
+    for (auto block : {std::make_pair(0, 10), std::make_pair(20, 5)}) {
+        auto blockMsg = writeEventMsg->add_blocks();
+        blockMsg->set_offset(block.first);
+        blockMsg->set_size(block.second);
+        blockMsg->set_storage_id("");
+        blockMsg->set_file_id("");
+    }
+    EXPECT_EQ(eventMsg.SerializeAsString(),
+        event->serializeAndDestroy()->SerializeAsString());
+}
+
+TEST_F(WriteEventTest, aggregateShouldCoalesceFragmentedBlocks)
+{
+    auto limits = std::make_shared<WriteEvent::FragmentationLimits>();
+    limits->coalesceBlocks = 4;
+    limits->coalesceGap = 5;
+    event->setFragmentationLimits(limits);
+
+    for (off_t offset = 15; offset < 60; offset += 15)
+        event->aggregate(writeEventPtr(offset, 10, "fileUuid1"));
+    EXPECT_TRUE(
+        blocks({{0, 10}, {15, 25}, {30, 40}, {45, 55}}) == event->blocks());
+
+    event->aggregate(writeEventPtr(100, 10, "fileUuid1"));
+    EXPECT_TRUE(blocks({{0, 55}, {100, 110}}) == event->blocks());
+    EXPECT_EQ(50, event->size());
+}
+
+TEST_F(WriteEventTest, fullShouldBeSetOnMaxBlocks)
+{
+    auto limits = std::make_shared<WriteEvent::FragmentationLimits>();
+    limits->maxBlocks = 3;
+    event->setFragmentationLimits(limits);
+
+    event->aggregate(writeEventPtr(20, 10, "fileUuid1"));
+    EXPECT_FALSE(event->full());
+
+    event->aggregate(writeEventPtr(40, 10, "fileUuid1"));
+    EXPECT_TRUE(event->full());
+
+    EXPECT_FALSE(writeEventPtr(0, 10, "fileUuid1")->full());
+}
+
+TEST_F(ReadEventTest, collapseShouldMergeBlocksOfStorageFile)
+{
+    event->aggregate(20, 10);
+    event->aggregate(std::make_unique<ReadEvent>(
+        40, 10, "fileUuid1", "storageId", "fileId"));
+    event->aggregate(60, 10);
+    const auto sizeBefore = event->footprint();
+
+    event->collapse();
+    EXPECT_EQ(3u, event->blocks().iterative_size());
+    EXPECT_EQ(4, event->counter());
+    EXPECT_EQ(40, event->size());
+    EXPECT_GT(sizeBefore, event->footprint());
+}
+
+TEST_F(WriteEventTest, collapseShouldMergeBlocksOfStorageFile)
+{
+    for (off_t offset = 20; offset < 100; offset += 20)
+        event->aggregate(writeEventPtr(offset, 10, "fileUuid1"));
+    const auto sizeBefore = event->footprint();
+
+    event->collapse();
+    EXPECT_TRUE(blocks({{0, 90}}) == event->blocks());
+    EXPECT_EQ(5, event->counter());
+    EXPECT_EQ(50, event->size());
+    EXPECT_GT(sizeBefore, event->footprint());
+}
+
+TEST(EventContainerTest, serializeShouldAdoptEventsInOrder)
+{
+    std::vector<std::unique_ptr<ReadEvent>> events;
+    events.emplace_back(readEventPtr(0, 10, "fileUuid1"));
+    events.emplace_back(readEventPtr(20, 5, "fileUuid2"));
+
+    auto clientMsg = one::messages::serialize(
+        EventContainer<ReadEvent>{std::move(events)});
+
+    ASSERT_TRUE(clientMsg->has_events());
+    const auto &eventsMsg = clientMsg->events().events();
+    ASSERT_EQ(2, eventsMsg.size());
+    EXPECT_EQ("fileUuid1", eventsMsg.Get(0).read_event().file_uuid());
+    EXPECT_EQ(10, eventsMsg.Get(0).read_event().size());
+    EXPECT_EQ("fileUuid2", eventsMsg.Get(1).read_event().file_uuid());
+    EXPECT_EQ(5, eventsMsg.Get(1).read_event().size());
+}
@@ -0,0 +1,107 @@
+/**
+ * @file subscription_queue_test.cc
+ * @author Krzysztof Trzepla
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "events/subscriptionQueue.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ::testing;
+using namespace one::client::events;
+
+struct SubscriptionQueueTest : public ::testing::Test {
+    std::unique_ptr<SubscriptionQueue> queue(bool deferred)
+    {
+        return std::make_unique<SubscriptionQueue>(
+            [this](const std::string &fileUuid) {
+                subscriptions.emplace_back(fileUuid);
+                return ++lastId;
+            },
+            [this](std::int64_t id) { cancellations.emplace_back(id); },
+            deferred);
+    }
+
+    std::int64_t lastId = 0;
+    std::vector<std::string> subscriptions;
+    std::vector<std::int64_t> cancellations;
+};
+
+TEST_F(SubscriptionQueueTest, addShouldSendSubscriptionOnceIfNotDeferred)
+{
+    auto subscriptionQueue = queue(false);
+
+    subscriptionQueue->add("uuid1");
+    subscriptionQueue->add("uuid1");
+    subscriptionQueue->add("uuid2");
+    subscriptionQueue->remove("uuid1");
+    subscriptionQueue->remove("uuid1");
+
+    EXPECT_EQ(std::vector<std::string>({"uuid1", "uuid2"}), subscriptions);
+    EXPECT_EQ(std::vector<std::int64_t>({1}), cancellations);
+    EXPECT_EQ(0u, subscriptionQueue->pending());
+}
+
+TEST_F(SubscriptionQueueTest, addShouldSendSubscriptionImmediatelyIfDeferred)
+{
+    auto subscriptionQueue = queue(true);
+
+    subscriptionQueue->add("uuid1");
+    subscriptionQueue->add("uuid1");
+    subscriptionQueue->add("uuid2");
+
+    EXPECT_EQ(std::vector<std::string>({"uuid1", "uuid2"}), subscriptions);
+    EXPECT_EQ(0u, subscriptionQueue->pending());
+
+    subscriptionQueue->flush();
+
+    EXPECT_EQ(2u, subscriptions.size());
+    EXPECT_TRUE(cancellations.empty());
+}
+
+TEST_F(SubscriptionQueueTest, removeShouldQueueCancellationUntilFlush)
+{
+    auto subscriptionQueue = queue(true);
+
+    subscriptionQueue->add("uuid1");
+    subscriptionQueue->remove("uuid1");
+    subscriptionQueue->remove("uuid2");
+
+    EXPECT_TRUE(cancellations.empty());
+    EXPECT_EQ(1u, subscriptionQueue->pending());
+
+    subscriptionQueue->flush();
+
+    EXPECT_EQ(std::vector<std::int64_t>({1}), cancellations);
+    EXPECT_EQ(0u, subscriptionQueue->pending());
+}
+
+TEST_F(SubscriptionQueueTest, addShouldCancelOutQueuedCancellation)
+{
+    auto subscriptionQueue = queue(true);
+    subscriptionQueue->add("uuid1");
+    subscriptionQueue->flush();
+    subscriptionQueue->add("uuid2");
+    subscriptionQueue->flush();
+
+    subscriptionQueue->remove("uuid1");
+    subscriptionQueue->add("uuid1");
+    subscriptionQueue->remove("uuid2");
+    subscriptionQueue->flush();
+
+    EXPECT_EQ(2u, subscriptions.size());
+    EXPECT_EQ(std::vector<std::int64_t>({2}), cancellations);
+
+    subscriptionQueue->add("uuid2");
+    subscriptionQueue->flush();
+
+    EXPECT_EQ(std::vector<std::string>({"uuid1", "uuid2", "uuid2"}),
+        subscriptions);
+}
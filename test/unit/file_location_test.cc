@@ -0,0 +1,72 @@
+/**
+ * @file file_location_test.cc
+ * @author Konrad Zemek
+ * @copyright (C) 2026 ACK CYFRONET AGH
+ * @copyright This software is released under the MIT license cited in
+ * 'LICENSE.txt'
+ */
+
+#include "messages/fuse/fileLocation.h"
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using namespace one::messages::fuse;
+
+namespace {
+FileLocation::FileBlocksMap blocks(off_t lower, off_t upper)
+{
+    FileLocation::FileBlocksMap result;
+    result += std::make_pair(
+        boost::icl::discrete_interval<off_t>::right_open(lower, upper),
+        FileBlock{"storageId", "fileId"});
+    return result;
+}
+}
+
+TEST(FileLocationTest, copiesShouldShareBlocksUntilModified)
+{
+    FileLocation location;
+    location.putBlocks(blocks(0, 10));
+
+    FileLocation copy = location;
+    EXPECT_EQ(&location.blocks(), &copy.blocks());
+
+    auto snapshot = location.blocksSnapshot();
+    location.putBlocks(blocks(10, 20));
+    copy.truncateBlocks(5);
+
+    EXPECT_NE(&location.blocks(), &copy.blocks());
+    EXPECT_EQ(blocks(0, 20), location.blocks());
+    EXPECT_EQ(blocks(0, 5), copy.blocks());
+    EXPECT_EQ(blocks(0, 10), *snapshot);
+}
+
+TEST(FileLocationTest, modificationOfUnsharedBlocksShouldNotCopyThem)
+{
+    FileLocation location;
+    location.putBlocks(blocks(0, 10));
+    const auto blocksAddress = &location.blocks();
+
+    location.putBlocks(blocks(10, 20));
+    location.truncateBlocks(15);
+    location.truncateBlocks(30);
+
+    EXPECT_EQ(blocksAddress, &location.blocks());
+    EXPECT_EQ(blocks(0, 15), location.blocks());
+}
+
+TEST(FileLocationTest, blocksShouldShareBlocksOfOtherLocation)
+{
+    FileLocation location;
+    location.putBlocks(blocks(0, 10));
+
+    FileLocation other;
+    other.putBlocks(blocks(20, 30));
+    location.blocks(other);
+
+    EXPECT_EQ(&other.blocks(), &location.blocks());
+
+    other.putBlocks(blocks(0, 10));
+    EXPECT_EQ(blocks(20, 30), location.blocks());
+}
@@ -27,6 +27,7 @@ public:
 
     MOCK_METHOD0(close, void());
     MOCK_METHOD1(send, void(const one::messages::ClientMessage &));
+    MOCK_CONST_METHOD0(bufferedSize, std::size_t());
 
     void send(one::messages::ClientMessage &&msg) override { send(msg); }
 };